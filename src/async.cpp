@@ -0,0 +1,159 @@
+#include "pch.h"
+
+#include "async.h"
+
+#include <array>
+#include <exception>
+#include <new>
+#include <utility>
+
+#include "error.h"
+
+namespace hermes::async {
+	namespace frame_pool {
+		namespace {
+			constexpr std::size_t BUCKET_SIZE  = 64;
+			constexpr std::size_t BUCKET_COUNT = 16; // frames of up to 1 KiB are pooled
+
+			struct FreeBlock {
+				FreeBlock* next;
+			};
+
+			struct FreeLists {
+				std::array<FreeBlock*, BUCKET_COUNT> heads {};
+
+				~FreeLists() {
+					for (FreeBlock* head : heads) {
+						while (head) {
+							::operator delete(std::exchange(head, head->next));
+						}
+					}
+				}
+			};
+
+			thread_local FreeLists _free_lists;
+
+			// Returns the bucket for `size`, or BUCKET_COUNT if frames of that size are not pooled.
+			constexpr std::size_t _bucket(const std::size_t size) {
+				const std::size_t bucket = (size + BUCKET_SIZE - 1) / BUCKET_SIZE - 1;
+				return bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT;
+			}
+		} // namespace
+
+		void* allocate(const std::size_t size) {
+			const std::size_t bucket = _bucket(size);
+			if (bucket == BUCKET_COUNT) {
+				return ::operator new(size);
+			}
+
+			if (FreeBlock* block = _free_lists.heads[bucket]) {
+				_free_lists.heads[bucket] = block->next;
+				return block;
+			}
+			return ::operator new((bucket + 1) * BUCKET_SIZE);
+		}
+
+		void deallocate(void* const ptr, const std::size_t size) noexcept {
+			const std::size_t bucket = _bucket(size);
+			if (bucket == BUCKET_COUNT) {
+				::operator delete(ptr);
+				return;
+			}
+
+			// A frame freed on another thread simply joins that thread's list
+			auto* block				  = static_cast<FreeBlock*>(ptr);
+			block->next				  = _free_lists.heads[bucket];
+			_free_lists.heads[bucket] = block;
+		}
+	} // namespace frame_pool
+
+	void Task::promise_type::unhandled_exception() noexcept {
+		try {
+			throw;
+		} catch (const std::exception& e) {
+			fatal("Unhandled exception in task: {}", e.what());
+		} catch (...) {
+			fatal("Unhandled exception in task");
+		}
+	}
+
+	void Reactor::ReadableAwaiter::await_suspend(const std::coroutine_handle<> waiter) {
+		dbg_assert(!reactor.m_fd_waiters.contains(fd));
+		reactor.m_fd_waiters[fd] = waiter;
+		reactor._watch(fd);
+	}
+
+	void Reactor::TimerAwaiter::await_suspend(const std::coroutine_handle<> waiter) {
+		reactor.m_timers.push({deadline, reactor.m_timer_sequence++, waiter});
+	}
+
+	void Reactor::ScheduleAwaiter::await_suspend(const std::coroutine_handle<> waiter) {
+		reactor._enqueue({{}, waiter});
+	}
+
+	void Reactor::post(std::function<void()> callback) { _enqueue({std::move(callback), {}}); }
+
+	void Reactor::_enqueue(Posted posted) {
+		{
+			std::lock_guard lock {m_posted_mutex};
+			m_posted.push_back(std::move(posted));
+		}
+		_wake();
+	}
+
+	std::size_t Reactor::run_once(clock_t::duration timeout) {
+		const time_point_t now = clock_t::now();
+		if (!m_timers.empty()) {
+			timeout = std::min(timeout, std::max(m_timers.top().deadline - now, clock_t::duration::zero()));
+		}
+
+		std::size_t ran = _wait(timeout);
+		ran += _run_timers();
+		ran += _run_posted();
+		return ran;
+	}
+
+	std::size_t Reactor::_run_timers() {
+		const time_point_t now = clock_t::now();
+		std::size_t		   ran = 0;
+		while (!m_timers.empty() && m_timers.top().deadline <= now) {
+			const std::coroutine_handle<> waiter = m_timers.top().waiter;
+			m_timers.pop();
+			waiter.resume();
+			++ran;
+		}
+		return ran;
+	}
+
+	std::size_t Reactor::_run_posted() {
+		std::vector<Posted> posted;
+		{
+			std::lock_guard lock {m_posted_mutex};
+			posted.swap(m_posted);
+		}
+
+		for (auto& [callback, waiter] : posted) {
+			waiter ? waiter.resume() : callback();
+		}
+		return posted.size();
+	}
+
+	void Reactor::_destroy_waiters() noexcept {
+		// Every suspended task waits on exactly one thing, so each frame is destroyed once
+		for (; !m_timers.empty(); m_timers.pop()) {
+			m_timers.top().waiter.destroy();
+		}
+		for (const auto& [fd, waiter] : m_fd_waiters) {
+			waiter.destroy();
+		}
+		m_fd_waiters.clear();
+
+		std::lock_guard lock {m_posted_mutex};
+		for (const auto& [callback, waiter] : m_posted) {
+			if (waiter) {
+				waiter.destroy();
+			}
+		}
+		m_posted.clear();
+	}
+} // namespace hermes::async
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace hermes::async {
+	// Recycles coroutine frames. Freed frames are kept on per-thread lists bucketed by size, so starting a task of a
+	// size seen before does not touch the global heap. Large frames bypass the pool.
+	namespace frame_pool {
+		[[nodiscard]] void* allocate(std::size_t size);
+		void				deallocate(void* ptr, std::size_t size) noexcept;
+	} // namespace frame_pool
+
+	// A fire-and-forget coroutine. It starts running as soon as it is called and frees its own frame when it finishes.
+	// An exception escaping the coroutine is fatal.
+	class Task {
+	public:
+		struct promise_type {
+			Task			   get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void			   return_void() noexcept {}
+			void			   unhandled_exception() noexcept;
+
+			static void* operator new(std::size_t size) { return frame_pool::allocate(size); }
+			static void	 operator delete(void* ptr, std::size_t size) noexcept { frame_pool::deallocate(ptr, size); }
+		};
+	};
+
+	// A single-threaded event loop that resumes coroutines when a file descriptor becomes readable, a timer expires or
+	// work is posted from another thread. The thread calling `run_once()` (Hermes' main thread, which also owns SDL)
+	// is the only one that resumes coroutines, so tasks may call tray and display functions directly; other threads
+	// hand work over with `post()` or `co_await schedule()`.
+	//
+	// On Linux the reactor waits on one epoll instance; an eventfd wakes it for posted work. On Windows only timers and
+	// posted work are supported.
+	//
+	// Destroying the reactor destroys every coroutine still suspended on it, including ones moved over with
+	// `schedule()` that have not been resumed yet. No other thread may post to a reactor that is being destroyed.
+	class Reactor {
+	public:
+		using clock_t	   = std::chrono::steady_clock;
+		using time_point_t = clock_t::time_point;
+
+		struct ReadableAwaiter {
+			Reactor& reactor;
+			int		 fd;
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> waiter);
+			void await_resume() const noexcept {}
+		};
+
+		struct TimerAwaiter {
+			Reactor&	 reactor;
+			time_point_t deadline;
+
+			bool await_ready() const noexcept { return deadline <= clock_t::now(); }
+			void await_suspend(std::coroutine_handle<> waiter);
+			void await_resume() const noexcept {}
+		};
+
+		struct ScheduleAwaiter {
+			Reactor& reactor;
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> waiter);
+			void await_resume() const noexcept {}
+		};
+
+		Reactor();
+
+		~Reactor();
+		Reactor(const Reactor&)			   = delete;
+		Reactor& operator=(const Reactor&) = delete;
+		Reactor(Reactor&&)				   = delete;
+		Reactor& operator=(Reactor&&)	   = delete;
+
+		// Suspends the awaiting coroutine until `fd` is readable. Only one coroutine may wait on a descriptor at a time.
+		[[nodiscard]] ReadableAwaiter readable(int fd) { return {*this, fd}; }
+
+		// Suspends the awaiting coroutine for at least `duration`.
+		[[nodiscard]] TimerAwaiter sleep_for(clock_t::duration duration) { return {*this, clock_t::now() + duration}; }
+
+		// Moves the awaiting coroutine onto the reactor's thread. Safe to use from any thread.
+		[[nodiscard]] ScheduleAwaiter schedule() { return {*this}; }
+
+		// Queues `callback` to run on the reactor's thread. Safe to call from any thread.
+		void post(std::function<void()> callback);
+
+		// Waits up to `timeout` for readiness, expired timers or posted work, and runs everything that became ready.
+		// Returns the number of coroutines and callbacks that ran.
+		std::size_t run_once(clock_t::duration timeout);
+	private:
+		struct Timer {
+			time_point_t			deadline;
+			std::uint64_t			sequence; // keeps timers with equal deadlines in FIFO order
+			std::coroutine_handle<> waiter;
+
+			bool operator>(const Timer& other) const noexcept {
+				return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+			}
+		};
+
+		std::priority_queue<Timer, std::vector<Timer>, std::greater<>> m_timers;
+		std::uint64_t												   m_timer_sequence = 0;
+
+		std::unordered_map<int, std::coroutine_handle<>> m_fd_waiters;
+
+		// Work handed over by `post()` (a callback) or `schedule()` (a coroutine), in FIFO order. Coroutines are kept
+		// as handles rather than wrapped in callbacks so that the destructor can destroy the ones still queued.
+		struct Posted {
+			std::function<void()>	callback;
+			std::coroutine_handle<> waiter;
+		};
+
+		std::mutex			m_posted_mutex;
+		std::vector<Posted> m_posted;
+
+		// Platform state (unused on Windows)
+		int m_poll_fd = -1;
+		int m_wake_fd = -1;
+
+		std::size_t _run_timers();
+		void		_enqueue(Posted posted);
+		std::size_t _run_posted();
+		void		_destroy_waiters() noexcept;
+
+		// Platform-specific
+		void		_watch(int fd);
+		void		_wake();
+		std::size_t _wait(clock_t::duration timeout);
+	};
+} // namespace hermes::async
@@ -9,6 +9,10 @@
 
 #include "sys.h"
 
+namespace hermes::notify {
+	void show_fatal_error(const std::string& message) noexcept;
+} // namespace hermes::notify
+
 template<class... Args>
 inline void eprint(std::format_string<Args...> fmt, Args&&... args) {
 	std::print(stderr, fmt, std::forward<Args>(args)...);
@@ -27,9 +31,12 @@ namespace hermes {
 		eprintln("\033[38;5;1merror\033[m: {}", std::format(fmt, std::forward<Args>(args)...));
 	}
 	
+	// Prints the error, shows it in a message box and terminates.
 	template<class... Args>
 	[[noreturn]] inline void fatal(std::format_string<Args...> fmt, Args&&... args) {
-		eprintln("\033[38;5;160mfatal error\033[m: {}", std::format(fmt, std::forward<Args>(args)...));
+		const std::string message = std::format(fmt, std::forward<Args>(args)...);
+		eprintln("\033[38;5;160mfatal error\033[m: {}", message);
+		notify::show_fatal_error(message);
 		std::terminate();
 	}
 
@@ -0,0 +1,35 @@
+#include "pch.h"
+
+#include "focus.h"
+
+#include <ranges>
+#include <string_view>
+
+namespace hermes::focus {
+	namespace {
+		std::string_view _trim(std::string_view text) {
+			constexpr std::string_view WHITESPACE = " \t\n";
+			text.remove_prefix(std::min(text.find_first_not_of(WHITESPACE), text.size()));
+			text.remove_suffix(text.size() - std::min(text.find_last_not_of(WHITESPACE) + 1, text.size()));
+			return text;
+		}
+	} // namespace
+
+	std::vector<Rule> parse_rules(const std::string_view text) {
+		constexpr std::string_view EXECUTABLE_PREFIX = "exe:";
+
+		std::vector<Rule> rules;
+		for (const auto part : text | std::views::split(',')) {
+			const std::string_view entry = _trim(std::string_view {part.begin(), part.end()});
+			if (entry.starts_with(EXECUTABLE_PREFIX)) {
+				const std::string_view name = _trim(entry.substr(EXECUTABLE_PREFIX.size()));
+				if (!name.empty()) {
+					rules.push_back({Rule::Kind::executable, std::string {name}});
+				}
+			} else if (!entry.empty()) {
+				rules.push_back({Rule::Kind::wm_class, std::string {entry}});
+			}
+		}
+		return rules;
+	}
+} // namespace hermes::focus
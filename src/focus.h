@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct _XDisplay;
+union _XEvent;
+
+namespace hermes::focus {
+	// Matches a window by its WM_CLASS (instance or class name, e.g. `steam_app_570`) or, when written as `exe:<name>`,
+	// by the name of the process that owns it. Process names come from `/proc/<pid>/comm`, which the kernel cuts to 15
+	// characters, so only the first 15 characters of an `exe:` rule are compared.
+	struct Rule {
+		static constexpr std::size_t EXECUTABLE_NAME_SIZE = 15;
+
+		enum class Kind {
+			wm_class,
+			executable
+		};
+
+		Kind		kind;
+		std::string name;
+	};
+
+	// Parses a comma-separated list of rules, e.g. `"steam_app_570, exe:factorio"`. Empty entries are ignored.
+	[[nodiscard]] std::vector<Rule> parse_rules(std::string_view text);
+
+	// Tracks whether the focused window matches any rule.
+	//
+	// On X11 the watcher subscribes once to property changes on the root window and only looks at a window when
+	// `_NET_ACTIVE_WINDOW` changes. A window's WM_CLASS and PID are resolved the first time it gains focus; the result is
+	// remembered in a small table keyed by window ID. The watcher also subscribes to each remembered window, and
+	// forgets it when it is destroyed (so a reused ID is looked at afresh) or when its WM_CLASS or PID changes (so a
+	// window that sets them after mapping is judged again). Without rules, or without an X display (e.g. under
+	// Wayland), the watcher does nothing.
+	class FocusWatcher {
+	public:
+		// Connects to `display_name` (or `$DISPLAY` if null).
+		explicit FocusWatcher(std::vector<Rule> rules, const char* display_name = nullptr);
+
+		~FocusWatcher();
+		FocusWatcher(const FocusWatcher&)			 = delete;
+		FocusWatcher& operator=(const FocusWatcher&) = delete;
+		FocusWatcher(FocusWatcher&&)				 = delete;
+		FocusWatcher& operator=(FocusWatcher&&)		 = delete;
+
+		// Returns the X connection's descriptor, or -1 if the watcher is inactive.
+		[[nodiscard]] int fd() const noexcept;
+
+		// Handles every pending X event without blocking. Returns `true` if `matches()` changed. Call it once before
+		// first waiting on `fd()`: events that arrived during construction may already sit in Xlib's queue.
+		bool dispatch();
+
+		// Returns `true` if the focused window matches a rule.
+		[[nodiscard]] bool matches() const noexcept { return m_matches; }
+	private:
+		struct CacheEntry {
+			unsigned long window  = 0;
+			bool		  matches = false;
+		};
+
+		static constexpr std::size_t CACHE_SIZE = 16;
+
+		std::vector<Rule> m_rules;
+		_XDisplay*		  m_display			   = nullptr;
+		unsigned long	  m_root			   = 0;
+		unsigned long	  m_active_window_atom = 0;
+		unsigned long	  m_pid_atom		   = 0;
+		unsigned long	  m_active_window	   = 0;
+		bool			  m_matches			   = false;
+
+		std::array<CacheEntry, CACHE_SIZE> m_cache {};
+		std::size_t						   m_cache_next = 0;
+
+		// Applies one event to the cache. Returns `true` if the active window must be looked at again.
+		bool _handle_event(const _XEvent& event);
+
+		// Drops `window` from the cache, unsubscribing from it unless it no longer exists.
+		void _forget(unsigned long window, bool still_exists);
+
+		// Re-reads `_NET_ACTIVE_WINDOW` and updates `m_matches`, consulting and filling the cache.
+		void _update_active_window();
+		bool _window_matches(unsigned long window);
+	};
+} // namespace hermes::focus
@@ -0,0 +1,127 @@
+#include "pch.h"
+
+#include "inhibit.h"
+
+#include <bitset>
+#include <chrono>
+#include <optional>
+#include <system_error>
+
+#include "error.h"
+#include "notify.h"
+#include "registry.h"
+#include "sys.h"
+
+namespace hermes::inhibit {
+	namespace {
+		constexpr std::string_view REGISTRY_REASON = "hermes";
+
+		// How long to wait before trying the registry again after finding it full.
+		constexpr std::chrono::seconds REGISTRY_RETRY_INTERVAL {60};
+
+		std::bitset<static_cast<std::size_t>(Source::count_)> _requests;
+
+		// Whether the screensaver is currently disabled on our behalf.
+		bool _applied = false;
+
+		// Whether this process holds the host-wide registry.
+		bool _held = false;
+
+		bool _paused = false;
+
+		// When the registry may next be tried after it was found full; unset while it is not full.
+		std::optional<std::chrono::steady_clock::time_point> _registry_retry;
+
+		registry::InhibitRegistry* _registry() {
+			static std::optional<registry::InhibitRegistry> instance = []() -> std::optional<registry::InhibitRegistry> {
+				try {
+					return registry::InhibitRegistry {};
+				} catch (const std::system_error& e) {
+					// Platforms without a registry at all are not worth an error on every launch
+					if (e.code() == std::errc::function_not_supported) {
+						dbg("{}, inhibiting for this process only\n", e.what());
+					} else {
+						error(
+							"Host-wide inhibit registry unavailable, inhibiting for this process only: {}", e.what());
+						notify::send(
+							"Inhibiting for this process only", std::format("Inhibit registry unavailable: {}", e.what()));
+					}
+					return std::nullopt;
+				}
+			}();
+			return instance ? &*instance : nullptr;
+		}
+
+		void _apply() {
+			const bool wanted	= _requests.any() && !_paused;
+			auto*	   registry = _registry();
+
+			if (registry && wanted != _held) {
+				if (wanted) {
+					const auto now = std::chrono::steady_clock::now();
+					if (!_registry_retry || now >= *_registry_retry) {
+						_held = registry->acquire(REGISTRY_REASON);
+						if (!_held && !_registry_retry) {
+							error(
+								"Inhibit registry is full ({} slots), inhibiting for this process only",
+								registry::InhibitRegistry::CAPACITY);
+							notify::send(
+								"Inhibiting for this process only",
+								std::format(
+									"Inhibit registry is full ({} slots)", registry::InhibitRegistry::CAPACITY));
+						}
+						_registry_retry = _held ? std::nullopt : std::optional {now + REGISTRY_RETRY_INTERVAL};
+					}
+				} else {
+					registry->release(REGISTRY_REASON);
+					_held = false;
+				}
+			}
+
+			// Follow every live holder on the host, not just this process
+			const bool keep_awake = !_paused && (wanted || (registry && registry->any_live_holder()));
+			if (keep_awake == _applied) {
+				return;
+			}
+
+			keep_awake ? display::disable_screensaver() : display::enable_screensaver();
+			_applied = keep_awake;
+		}
+	} // namespace
+
+	void request(const Source source, const bool active) {
+		dbg_assert(source < Source::count_);
+		_requests.set(static_cast<std::size_t>(source), active);
+		_apply();
+	}
+
+	bool is_requested(const Source source) noexcept { return _requests.test(static_cast<std::size_t>(source)); }
+
+	bool is_active() noexcept { return _requests.any(); }
+
+	void set_paused(const bool paused) {
+		dbg("{} inhibition\n", paused ? "Pausing" : "Resuming");
+		_paused = paused;
+		_apply();
+	}
+
+	bool is_paused() noexcept { return _paused; }
+
+	void refresh() {
+		if (auto* registry = _registry()) {
+			registry->reap();
+		}
+		_apply();
+	}
+
+	void release_all() {
+		_requests.reset();
+		_apply();
+
+		if (_applied) {
+			dbg("Leaving screensaver disabled for other inhibit registry holders\n");
+			return;
+		}
+		display::enable_screensaver();
+	}
+} // namespace hermes::inhibit
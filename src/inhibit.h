@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+namespace hermes::inhibit {
+	// The inputs that can ask for the display to be kept awake. The screensaver is disabled while at least one of them
+	// is active, or while any other process holds the host-wide inhibit registry (see `registry.h`).
+	enum class Source : unsigned {
+		user,  // the "Disable Sleep" checkbox
+		media, // active audio playback
+		focus, // a window matching a focus rule is focused
+		count_
+	};
+
+	// Records whether `source` wants the display kept awake and updates the screensaver if the overall decision changed.
+	// SDL's video subsystem must be initialized before calling this function.
+	void request(Source source, bool active);
+
+	// Returns `true` if `source` currently wants the display kept awake.
+	[[nodiscard]] bool is_requested(Source source) noexcept;
+
+	// Returns `true` if any source currently wants the display kept awake.
+	[[nodiscard]] bool is_active() noexcept;
+
+	// Pauses or resumes inhibition as a whole (e.g. while running on battery). While paused, requests are still
+	// recorded but the screensaver is enabled and this process gives up its registry hold.
+	// SDL's video subsystem must be initialized before calling this function.
+	void set_paused(bool paused);
+
+	// Returns `true` if inhibition is paused.
+	[[nodiscard]] bool is_paused() noexcept;
+
+	// Reclaims registry slots left by exited processes and re-evaluates the decision against the other holders.
+	// SDL's video subsystem must be initialized before calling this function.
+	void refresh();
+
+	// Drops every request and re-enables the screensaver unless another process still holds the registry.
+	// SDL's video subsystem must be initialized before calling this function.
+	void release_all();
+} // namespace hermes::inhibit
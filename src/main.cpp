@@ -3,7 +3,6 @@
 #include <SDL3/SDL_error.h>
 #include <SDL3/SDL_events.h>
 #include <SDL3/SDL_init.h>
-#include <SDL3/SDL_messagebox.h>
 
 #include <nameof/nameof.hpp>
 
@@ -17,37 +16,34 @@
 #include <string>
 #include <vector>
 
+#include "async.h"
 #include "error.h"
+#include "focus.h"
+#include "inhibit.h"
+#include "media.h"
+#include "notify.h"
+#include "power.h"
 #include "sys.h"
+#include "uevent.h"
 
 using namespace hermes;
 
 namespace {
-	void show_error_messagebox(const std::string& message) {
-		std::string				   title = this_process::filename().generic_string() + " - Error";
-		static constexpr const int button_flags =
-			SDL_MESSAGEBOX_BUTTON_RETURNKEY_DEFAULT | SDL_MESSAGEBOX_BUTTON_ESCAPEKEY_DEFAULT;
-		std::vector<SDL_MessageBoxButtonData> buttons {{button_flags, 1, "ok"}};
-
-		SDL_MessageBoxData data {
-			.flags		 = SDL_MESSAGEBOX_ERROR | SDL_MESSAGEBOX_BUTTONS_LEFT_TO_RIGHT,
-			.window		 = nullptr,
-			.title		 = title.c_str(),
-			.message	 = message.c_str(),
-			.numbuttons	 = static_cast<int>(buttons.size()),
-			.buttons	 = buttons.data(),
-			.colorScheme = nullptr};
-	}
-
 	void open_url(const std::string& url) {
 		dbg("Opening URL '{}'...", url);
 		if (!dbg_validate(SDL_OpenURL(url.c_str()))) {
 			error("Failed to open URL '{}': SDL: {}", url, SDL_GetError());
-			show_error_messagebox("Could not open URL");
+			notify::send("Could not open URL", url);
 			return;
 		}
 	}
 
+	// Returns the value of the environment variable `name`, or an empty string if it is not set.
+	std::string environment_variable(const char* name) {
+		const char* value = std::getenv(name);
+		return value ? value : "";
+	}
+
 	namespace event_queue {
 		SDL_Event _current_event;
 
@@ -76,12 +72,30 @@ private:
 	// State
 	bool m_running = true;
 
+	// Sources
+	async::Reactor		   m_reactor;
+	uevent::Listener	   m_uevents;
+	media::PlaybackMonitor m_playback_monitor;
+	power::PowerMonitor	   m_power_monitor;
+	focus::FocusWatcher	   m_focus_watcher;
+
 	// Resources
 	static const std::filesystem::path TRAY_ICON_PATH;
 
 	// Initialization
 	static void set_metadata();
 
+	// Background tasks
+	static constexpr std::chrono::milliseconds SDL_POLL_INTERVAL {1000 / 10}; // the main loop's wake-up rate
+	static constexpr std::chrono::seconds	   SOURCE_POLL_INTERVAL {2};
+
+	// Comma-separated focus rules (see `focus::parse_rules()`)
+	static constexpr const char* FOCUS_RULES_VARIABLE = "HERMES_FOCUS_RULES";
+
+	async::Task watch_uevents();
+	async::Task watch_focus();
+	async::Task poll_sources();
+
 	// Callbacks
 	static void callback_toggle_screensaver(TrayEntry&);
 	static void callback_quit(TrayEntry&);
@@ -90,7 +104,8 @@ private:
 
 const std::filesystem::path Hermes::TRAY_ICON_PATH = this_process::directory() / "hermes32.png";
 
-Hermes::Hermes() {
+Hermes::Hermes()
+	: m_focus_watcher {focus::parse_rules(environment_variable(FOCUS_RULES_VARIABLE))} {
 	dbg("Querying SDL version... {}.{}.{}\n", SDL_MAJOR_VERSION, SDL_MICRO_VERSION, SDL_MINOR_VERSION);
 	set_metadata();
 	global_initialize();
@@ -107,12 +122,19 @@ void Hermes::run() {
 	TrayMenu   menu = tray.new_menu();
 	menu.add_label("Quit").set_callback(callback_quit);
 	menu.add_separator();
-	menu.add_checkbox("Disable Sleep", !display::is_screensaver_enabled()).set_callback(callback_toggle_screensaver);
+	menu.add_checkbox("Disable Sleep", true).set_callback(callback_toggle_screensaver);
 	menu.add_separator();
 	menu.add_label("About Hermes").set_callback(callback_about);
 
-	// Disable sleep when app starts
-	display::disable_screensaver();
+	// Disable sleep when app starts (unless the power policy says otherwise)
+	inhibit::set_paused(m_power_monitor.should_pause());
+	inhibit::request(inhibit::Source::user, true);
+	inhibit::request(inhibit::Source::focus, m_focus_watcher.matches());
+
+	// Start background tasks; they run whenever the main loop waits on the reactor
+	watch_uevents();
+	watch_focus();
+	poll_sources();
 
 	// Main loop
 	dbg("Starting main loop\n");
@@ -125,12 +147,88 @@ void Hermes::run() {
 			}
 		}
 
-		SDL_Delay(1000 / 10);
+		// The loop still wakes at 10 Hz to pump SDL: SDL has no descriptor to wait on, and the tray only dispatches
+		// its menu callbacks from inside the event pump, so an SDL event watch could not wake the reactor either.
+		// Background tasks add no wake-ups of their own.
+		m_reactor.run_once(SDL_POLL_INTERVAL);
 	}
 	dbg("Ending main loop\n");
 
 	// Re-enable sleep when app closes
-	display::enable_screensaver();
+	inhibit::release_all();
+}
+
+async::Task Hermes::watch_uevents() {
+	if (m_uevents.fd() < 0) {
+		co_return;
+	}
+
+	for (;;) {
+		co_await m_reactor.readable(m_uevents.fd());
+
+		bool power_changed = false;
+		bool sound_changed = false;
+		const bool complete = m_uevents.dispatch([&](const std::string_view message) {
+			power_changed |= m_power_monitor.apply_uevent(message);
+			sound_changed |= media::is_device_event(message);
+		});
+		if (!complete) {
+			power_changed |= m_power_monitor.resynchronize();
+			sound_changed = true;
+		}
+
+		// A hot-plugged card announces several devices at once; rescan once per batch. Its status files may only
+		// appear after the events, so the monitor keeps rescanning on the next few polls.
+		if (sound_changed) {
+			m_playback_monitor.device_changed();
+		}
+
+		if (!power_changed) {
+			continue;
+		}
+
+		const bool paused = m_power_monitor.should_pause();
+		inhibit::set_paused(paused);
+		if (!inhibit::is_active()) {
+			continue; // nothing was or will be held awake, so the change makes no difference to the user
+		}
+		if (paused) {
+			notify::send(
+				"Sleep re-enabled",
+				std::format(
+					"{} ({}%)",
+					m_power_monitor.on_battery() ? "Running on battery" : "Battery low",
+					m_power_monitor.battery_percent()),
+				notify::Urgency::low);
+		} else {
+			notify::send("Sleep disabled again", "Back on AC power", notify::Urgency::low);
+		}
+	}
+}
+
+async::Task Hermes::watch_focus() {
+	if (m_focus_watcher.fd() < 0) {
+		co_return;
+	}
+
+	// Dispatch before each wait: events read during construction may already be queued without the descriptor being
+	// readable
+	for (;;) {
+		if (m_focus_watcher.dispatch()) {
+			inhibit::request(inhibit::Source::focus, m_focus_watcher.matches());
+		}
+		co_await m_reactor.readable(m_focus_watcher.fd());
+	}
+}
+
+async::Task Hermes::poll_sources() {
+	for (;;) {
+		// Without playback devices this does no work
+		inhibit::request(inhibit::Source::media, m_playback_monitor.is_playing());
+		inhibit::refresh();
+
+		co_await m_reactor.sleep_for(SOURCE_POLL_INTERVAL);
+	}
 }
 
 void Hermes::set_metadata() {
@@ -144,14 +242,9 @@ void Hermes::set_metadata() {
 	set_type(APPLICATION);
 }
 
-void Hermes::callback_toggle_screensaver([[maybe_unused]] TrayEntry& entry) {
-	using namespace display;
-
-	// Toggle screensaver
-	is_screensaver_enabled() ? disable_screensaver() : enable_screensaver();
-
-	// Make sure checkbox is properly checked
-	dbg_assert(entry.is_checked() == !is_screensaver_enabled());
+void Hermes::callback_toggle_screensaver(TrayEntry& entry) {
+	// SDL has already toggled the checkbox; it is the user's request
+	inhibit::request(inhibit::Source::user, entry.is_checked());
 }
 
 void Hermes::callback_quit(TrayEntry&) {
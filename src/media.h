@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace hermes::media {
+	// Returns `true` if the uevent `message` announces a sound device being added or removed.
+	[[nodiscard]] bool is_device_event(std::string_view message);
+
+	// Detects whether any audio playback stream is running.
+	//
+	// On Linux, every playback substream's status file (`<root>/card*/pcm*p/sub*/status`) is opened by `rescan()` and
+	// re-read in place on each call to `is_playing()`. PipeWire and PulseAudio drive the same ALSA substreams, so no
+	// sound-server connection is needed. If the machine has no audio device, the monitor holds no descriptors and
+	// `is_playing()` does no work. Hot-plugged devices are picked up by calling `device_changed()` when
+	// `is_device_event()` reports a change.
+	class PlaybackMonitor {
+	public:
+		static const std::filesystem::path DEFAULT_ROOT;
+
+		// How long after a device event `is_playing()` keeps rescanning. The kernel announces a new card before its
+		// `/proc/asound` entries exist, so a scan made right after the event may not see it yet.
+		static constexpr std::chrono::seconds SETTLE_PERIOD {10};
+
+		// Scans `root` for playback substreams.
+		explicit PlaybackMonitor(const std::filesystem::path& root = DEFAULT_ROOT);
+
+		~PlaybackMonitor();
+		PlaybackMonitor(const PlaybackMonitor&)			   = delete;
+		PlaybackMonitor& operator=(const PlaybackMonitor&) = delete;
+		PlaybackMonitor(PlaybackMonitor&& other) noexcept;
+		PlaybackMonitor& operator=(PlaybackMonitor&& other) noexcept;
+
+		// Closes every status file and scans the root again.
+		void rescan();
+
+		// Rescans now, and again on every call to `is_playing()` during the next `SETTLE_PERIOD`.
+		void device_changed();
+
+		// Returns `true` if at least one playback substream was found.
+		[[nodiscard]] bool has_devices() const noexcept { return !m_status_fds.empty(); }
+
+		// Returns `true` if any playback substream is running.
+		[[nodiscard]] bool is_playing();
+	private:
+		std::filesystem::path				  m_root;
+		std::vector<int>					  m_status_fds;
+		std::chrono::steady_clock::time_point m_settle_until {};
+	};
+} // namespace hermes::media
@@ -0,0 +1,98 @@
+#include "pch.h"
+
+#include "notify.h"
+
+#include <SDL3/SDL_messagebox.h>
+
+#include <format>
+#include <string>
+#include <utility>
+
+#include "error.h"
+#include "sys.h"
+
+namespace hermes::notify {
+	Notifier::Notifier(std::vector<std::string> command)
+		: m_command {std::move(command)},
+		  m_worker {[this](std::stop_token stop) { _run(std::move(stop)); }} {}
+
+	Notifier::~Notifier() {
+		m_worker.request_stop();
+		m_worker.join();
+	}
+
+	void Notifier::send(const std::string& summary, const std::string& body, const Urgency urgency) {
+		const std::string key = summary + '\n' + body;
+		{
+			std::lock_guard lock {m_mutex};
+
+			// Still waiting to be delivered: nothing new to say
+			for (const Message& queued : m_queue) {
+				if (queued.summary == summary && queued.body == body) {
+					return;
+				}
+			}
+
+			const auto now = clock_t::now();
+			std::erase_if(m_history, [&](const auto& entry) {
+				return entry.first != key && now - entry.second.last_queued >= COALESCE_WINDOW;
+			});
+
+			const auto [it, is_new] = m_history.try_emplace(key, History {now});
+			History&   history		= it->second;
+			if (!is_new && now - history.last_queued < COALESCE_WINDOW) {
+				++history.held_back;
+				return;
+			}
+
+			Message message {summary, body, urgency};
+			if (history.held_back) {
+				message.body += std::format("{}(repeated {} more times)", body.empty() ? "" : "\n", history.held_back);
+			}
+			history = {now};
+
+			if (m_queue.size() == MAX_QUEUED) {
+				m_queue.pop_front();
+			}
+			m_queue.push_back(std::move(message));
+		}
+		m_queued.notify_one();
+	}
+
+	void Notifier::_run(std::stop_token stop) {
+		std::unique_lock lock {m_mutex};
+		for (;;) {
+			m_queued.wait(lock, stop, [this] { return !m_queue.empty(); });
+			if (m_queue.empty()) {
+				return; // stop requested and nothing left to deliver
+			}
+
+			Message message = std::move(m_queue.front());
+			m_queue.pop_front();
+
+			lock.unlock();
+			if (m_available && !_deliver(message)) {
+				error("Desktop notifications are unavailable; further notifications are only logged");
+				m_available = false;
+			}
+			if (!m_available) {
+				eprintln("{}: {}", message.summary, message.body);
+			}
+			lock.lock();
+		}
+	}
+
+	void send(const std::string& summary, const std::string& body, const Urgency urgency) {
+		static Notifier notifier;
+		notifier.send(summary, body, urgency);
+	}
+
+	void show_fatal_error(const std::string& message) noexcept {
+		try {
+			const std::string title = this_process::filename().generic_string() + " - Error";
+			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, title.c_str(), message.c_str(), nullptr);
+		} catch (...) {
+			// Already failing; the message has been printed to stderr
+		}
+	}
+} // namespace hermes::notify
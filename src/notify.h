@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace hermes::notify {
+	enum class Urgency {
+		low,
+		normal,
+		critical
+	};
+
+	// Delivers desktop notifications on a worker thread so that the tray and main loop never wait on the notification
+	// service.
+	//
+	// On Linux, each notification is handed to `notify-send` (or whatever `command` names), which talks to the
+	// freedesktop notification service. A message identical to one already queued is merged into it, and a message
+	// identical to one delivered within `COALESCE_WINDOW` is held back and counted; the count is reported with the next
+	// delivery of that message. History older than `COALESCE_WINDOW` is dropped whenever a different message is sent,
+	// so messages with changing text (such as a battery percentage) do not accumulate.
+	class Notifier {
+	public:
+		using clock_t = std::chrono::steady_clock;
+
+		static constexpr std::chrono::seconds COALESCE_WINDOW {30};
+		static constexpr std::size_t		  MAX_QUEUED = 16;
+
+		explicit Notifier(std::vector<std::string> command = {"notify-send"});
+
+		// Delivers whatever is still queued, then stops the worker.
+		~Notifier();
+		Notifier(const Notifier&)			 = delete;
+		Notifier& operator=(const Notifier&) = delete;
+		Notifier(Notifier&&)				 = delete;
+		Notifier& operator=(Notifier&&)		 = delete;
+
+		// Queues a notification. Never blocks on delivery. Safe to call from any thread.
+		void send(const std::string& summary, const std::string& body = {}, Urgency urgency = Urgency::normal);
+	private:
+		struct Message {
+			std::string summary;
+			std::string body;
+			Urgency		urgency;
+		};
+
+		struct History {
+			clock_t::time_point last_queued;
+			unsigned			held_back = 0;
+		};
+
+		std::vector<std::string> m_command;
+		bool					 m_available = true; // worker thread only
+
+		std::mutex								 m_mutex;
+		std::condition_variable_any				 m_queued;
+		std::deque<Message>						 m_queue;
+		std::unordered_map<std::string, History> m_history;
+
+		std::jthread m_worker;
+
+		void _run(std::stop_token stop);
+
+		// Platform-specific. Returns `false` if the notification service cannot be reached at all.
+		bool _deliver(const Message& message);
+	};
+
+	// Queues a notification on the application's notifier.
+	void send(const std::string& summary, const std::string& body = {}, Urgency urgency = Urgency::normal);
+
+	// Shows a blocking error message box. Only for fatal errors, when the application is about to exit anyway.
+	void show_fatal_error(const std::string& message) noexcept;
+} // namespace hermes::notify
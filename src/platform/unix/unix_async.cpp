@@ -0,0 +1,102 @@
+#include "../../pch.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <system_error>
+
+#include "../../async.h"
+#include "../../error.h"
+
+namespace hermes::async {
+	namespace {
+		constexpr std::size_t MAX_EVENTS = 16;
+	}
+
+	Reactor::Reactor() {
+		m_poll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+		if (m_poll_fd < 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to create epoll instance");
+		}
+
+		m_wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		epoll_event event {};
+		event.events  = EPOLLIN;
+		event.data.fd = m_wake_fd;
+		if (m_wake_fd < 0 || ::epoll_ctl(m_poll_fd, EPOLL_CTL_ADD, m_wake_fd, &event) != 0) {
+			const int errc = errno;
+			if (m_wake_fd >= 0) {
+				::close(m_wake_fd);
+			}
+			::close(m_poll_fd);
+			throw std::system_error(errc, std::generic_category(), "Failed to create reactor wake-up event");
+		}
+	}
+
+	Reactor::~Reactor() {
+		_destroy_waiters();
+		::close(m_wake_fd);
+		::close(m_poll_fd);
+	}
+
+	void Reactor::_watch(const int fd) {
+		// Descriptors stay registered between waits and are re-armed with EPOLL_CTL_MOD; one-shot mode keeps a ready
+		// descriptor from waking the reactor again before its coroutine has drained it.
+		epoll_event event {};
+		event.events  = EPOLLIN | EPOLLONESHOT;
+		event.data.fd = fd;
+		if (::epoll_ctl(m_poll_fd, EPOLL_CTL_MOD, fd, &event) == 0) {
+			return;
+		}
+		if (errno != ENOENT || ::epoll_ctl(m_poll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+			m_fd_waiters.erase(fd);
+			throw std::system_error(errno, std::generic_category(), std::format("Failed to watch descriptor {}", fd));
+		}
+	}
+
+	void Reactor::_wake() {
+		const std::uint64_t one = 1;
+		[[maybe_unused]] const auto written = ::write(m_wake_fd, &one, sizeof(one));
+	}
+
+	std::size_t Reactor::_wait(const clock_t::duration timeout) {
+		// Round up so that a timer due in less than a millisecond does not turn into a busy loop
+		const auto timeout_ms = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+
+		std::array<epoll_event, MAX_EVENTS> events;
+		const int count = ::epoll_wait(m_poll_fd, events.data(), events.size(), static_cast<int>(timeout_ms));
+		if (count < 0) {
+			if (errno != EINTR) {
+				error("Failed to wait for events: {}", std::strerror(errno));
+			}
+			return 0;
+		}
+
+		std::size_t ran = 0;
+		for (const epoll_event& event : events | std::views::take(count)) {
+			const int fd = event.data.fd;
+			if (fd == m_wake_fd) {
+				std::uint64_t				value;
+				[[maybe_unused]] const auto read = ::read(m_wake_fd, &value, sizeof(value));
+				continue;
+			}
+
+			const auto it = m_fd_waiters.find(fd);
+			if (it == m_fd_waiters.end()) {
+				continue;
+			}
+			const std::coroutine_handle<> waiter = it->second;
+			m_fd_waiters.erase(it);
+			waiter.resume();
+			++ran;
+		}
+		return ran;
+	}
+} // namespace hermes::async
@@ -0,0 +1,269 @@
+#include "../../pch.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "../../error.h"
+#include "../../focus.h"
+#include "../../notify.h"
+
+namespace hermes::focus {
+	namespace {
+		using XErrorHandler_t = int (*)(Display*, XErrorEvent*);
+
+		// Events wanted from every cached window: DestroyNotify (StructureNotifyMask) so a reused window ID is never
+		// mistaken for the old window, and PropertyNotify so a WM_CLASS or PID set after mapping is seen.
+		constexpr long WINDOW_EVENT_MASK = StructureNotifyMask | PropertyChangeMask;
+
+		Display*		_trapped_display  = nullptr;
+		bool			_trapped_error	  = false;
+		XErrorHandler_t _previous_handler = nullptr;
+
+		int _trap_error(Display* display, XErrorEvent* event) {
+			if (display == _trapped_display) {
+				dbg("Ignoring X error {} on request {}\n", event->error_code, event->request_code);
+				_trapped_error = true;
+				return 0;
+			}
+			return _previous_handler ? _previous_handler(display, event) : 0;
+		}
+
+		// Catches errors on one X connection while in scope. A window can disappear between being named and being
+		// inspected, and Xlib's default handler would exit the process on the resulting BadWindow. The handler is
+		// process-wide, so it is only swapped in around the watcher's own requests, and errors on other connections
+		// (such as SDL's) still go to the previous handler.
+		class ErrorTrap {
+		public:
+			explicit ErrorTrap(Display* const display) {
+				dbg_assert(!_trapped_display);
+				_trapped_display  = display;
+				_trapped_error	  = false;
+				_previous_handler = XSetErrorHandler(_trap_error);
+			}
+
+			~ErrorTrap() {
+				XSync(_trapped_display, False);
+				XSetErrorHandler(_previous_handler);
+				_trapped_display = nullptr;
+			}
+
+			ErrorTrap(const ErrorTrap&)			   = delete;
+			ErrorTrap& operator=(const ErrorTrap&) = delete;
+
+			// Waits for every request made so far and returns `true` if any of them failed.
+			bool caught() const {
+				XSync(_trapped_display, False);
+				return _trapped_error;
+			}
+		};
+
+		// Reads a single 32-bit property of `window`, returning `fallback` if it is missing.
+		unsigned long _read_cardinal(
+			Display* const		display,
+			const Window		window,
+			const Atom			property,
+			const Atom			type,
+			const unsigned long fallback) {
+			Atom		   actual_type;
+			int			   actual_format;
+			unsigned long  count;
+			unsigned long  bytes_after;
+			unsigned char* data = nullptr;
+
+			const int status = XGetWindowProperty(
+				display,
+				window,
+				property,
+				0,
+				1,
+				False,
+				type,
+				&actual_type,
+				&actual_format,
+				&count,
+				&bytes_after,
+				&data);
+
+			unsigned long value = fallback;
+			if (status == Success && data && actual_format == 32 && count == 1) {
+				// 32-bit properties are returned as an array of `long`
+				value = *reinterpret_cast<unsigned long*>(data);
+			}
+			if (data) {
+				XFree(data);
+			}
+			return value;
+		}
+
+		// Returns the kernel's name for `pid`, which is cut to `Rule::EXECUTABLE_NAME_SIZE` characters.
+		std::string _process_name(const unsigned long pid) {
+			std::ifstream stream {std::format("/proc/{}/comm", pid)};
+			std::string	  name;
+			std::getline(stream, name);
+			return name;
+		}
+	} // namespace
+
+	FocusWatcher::FocusWatcher(std::vector<Rule> rules, const char* const display_name) : m_rules {std::move(rules)} {
+		if (m_rules.empty()) {
+			return;
+		}
+
+		dbg("Connecting to X display for focus tracking...");
+		m_display = XOpenDisplay(display_name);
+		if (!dbg_validate(m_display)) {
+			error("Focus rules are ignored: could not open X display");
+			notify::send("Focus rules are ignored", "Could not open the X display");
+			return;
+		}
+
+		m_root				 = DefaultRootWindow(m_display);
+		m_active_window_atom = XInternAtom(m_display, "_NET_ACTIVE_WINDOW", False);
+		m_pid_atom			 = XInternAtom(m_display, "_NET_WM_PID", False);
+
+		// Events that arrive while the first window is inspected are left in Xlib's queue for the first `dispatch()`
+		XSelectInput(m_display, m_root, PropertyChangeMask);
+		_update_active_window();
+	}
+
+	FocusWatcher::~FocusWatcher() {
+		if (m_display) {
+			XCloseDisplay(m_display);
+		}
+	}
+
+	int FocusWatcher::fd() const noexcept { return m_display ? ConnectionNumber(m_display) : -1; }
+
+	bool FocusWatcher::dispatch() {
+		if (!m_display) {
+			return false;
+		}
+
+		const bool previous = m_matches;
+		// Looking at a window takes round trips, during which Xlib reads further events off the socket into its own
+		// queue. Those no longer make the descriptor readable, so keep going until the queue is really empty.
+		do {
+			bool refresh = false;
+			while (XPending(m_display)) {
+				XEvent event;
+				XNextEvent(m_display, &event);
+				refresh |= _handle_event(event);
+			}
+
+			// A burst of focus changes only needs the final one
+			if (refresh) {
+				_update_active_window();
+			}
+		} while (XEventsQueued(m_display, QueuedAlready));
+		return m_matches != previous;
+	}
+
+	bool FocusWatcher::_handle_event(const XEvent& event) {
+		if (event.type == DestroyNotify) {
+			_forget(event.xdestroywindow.window, false);
+			return false;
+		}
+		if (event.type != PropertyNotify) {
+			return false;
+		}
+
+		const XPropertyEvent& property = event.xproperty;
+		if (property.window == m_root) {
+			return property.atom == m_active_window_atom;
+		}
+		if (property.atom == XA_WM_CLASS || property.atom == m_pid_atom) {
+			_forget(property.window, true);
+			return property.window == m_active_window;
+		}
+		return false;
+	}
+
+	void FocusWatcher::_update_active_window() {
+		ErrorTrap trap {m_display};
+		m_active_window = _read_cardinal(m_display, m_root, m_active_window_atom, XA_WINDOW, None);
+		if (m_active_window == None) {
+			m_matches = false;
+			return;
+		}
+
+		const auto cached = std::ranges::find(m_cache, m_active_window, &CacheEntry::window);
+		if (cached != m_cache.end()) {
+			m_matches = cached->matches;
+			return;
+		}
+
+		// Subscribe before reading, so that a property set in between is not missed
+		XSelectInput(m_display, m_active_window, WINDOW_EVENT_MASK);
+		m_matches = _window_matches(m_active_window);
+
+		// A window that is already gone cannot report its destruction, and its ID may be reused, so it is not cached.
+		// `_NET_ACTIVE_WINDOW` will move on shortly.
+		if (trap.caught()) {
+			m_matches = false;
+			return;
+		}
+
+		CacheEntry& entry = m_cache[m_cache_next];
+		if (entry.window != None) {
+			XSelectInput(m_display, entry.window, NoEventMask);
+		}
+		entry		 = {m_active_window, m_matches};
+		m_cache_next = (m_cache_next + 1) % CACHE_SIZE;
+	}
+
+	void FocusWatcher::_forget(const unsigned long window, const bool still_exists) {
+		const auto cached = std::ranges::find(m_cache, window, &CacheEntry::window);
+		if (cached == m_cache.end()) {
+			return;
+		}
+		*cached = {};
+		if (still_exists) {
+			ErrorTrap trap {m_display};
+			XSelectInput(m_display, window, NoEventMask);
+		}
+	}
+
+	bool FocusWatcher::_window_matches(const unsigned long window) {
+		std::string instance_name;
+		std::string class_name;
+		XClassHint	hint {};
+		if (XGetClassHint(m_display, window, &hint)) {
+			instance_name = hint.res_name ? hint.res_name : "";
+			class_name	  = hint.res_class ? hint.res_class : "";
+			XFree(hint.res_name);
+			XFree(hint.res_class);
+		}
+
+		const unsigned long pid = _read_cardinal(m_display, window, m_pid_atom, XA_CARDINAL, 0);
+		std::string			executable;
+
+		bool matches = false;
+		for (const Rule& rule : m_rules) {
+			if (rule.kind == Rule::Kind::wm_class) {
+				matches = rule.name == instance_name || rule.name == class_name;
+			} else {
+				if (executable.empty() && pid != 0) {
+					executable = _process_name(pid);
+				}
+				matches = !executable.empty() && rule.name.substr(0, Rule::EXECUTABLE_NAME_SIZE) == executable;
+			}
+			if (matches) {
+				break;
+			}
+		}
+		dbg("Focused window {:#x} ({}, {}, pid {}) {} a focus rule\n",
+			window,
+			instance_name,
+			class_name,
+			pid,
+			matches ? "matches" : "does not match");
+
+		return matches;
+	}
+} // namespace hermes::focus
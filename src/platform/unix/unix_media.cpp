@@ -0,0 +1,112 @@
+#include "../../pch.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "../../error.h"
+#include "../../media.h"
+#include "../../uevent.h"
+
+namespace hermes::media {
+	namespace {
+		bool _starts_with(const std::filesystem::path& path, const std::string_view prefix) {
+			return path.filename().native().starts_with(prefix);
+		}
+
+		// Playback PCM devices are named `pcm<N>p`, capture devices `pcm<N>c`.
+		bool _is_playback_pcm(const std::filesystem::path& path) {
+			return _starts_with(path, "pcm") && path.filename().native().ends_with('p');
+		}
+
+		void _close_all(std::vector<int>& fds) noexcept {
+			for (const int fd : fds) {
+				::close(fd);
+			}
+			fds.clear();
+		}
+	} // namespace
+
+	const std::filesystem::path PlaybackMonitor::DEFAULT_ROOT {"/proc/asound"};
+
+	bool is_device_event(const std::string_view message) {
+		const std::string_view action = uevent::find(message, "ACTION");
+		return uevent::find(message, "SUBSYSTEM") == "sound" && (action == "add" || action == "remove");
+	}
+
+	PlaybackMonitor::PlaybackMonitor(const std::filesystem::path& root) : m_root {root} { rescan(); }
+
+	void PlaybackMonitor::rescan() {
+		namespace fs = std::filesystem;
+		std::error_code ec;
+
+		_close_all(m_status_fds);
+		for (const auto& card : fs::directory_iterator {m_root, ec}) {
+			if (!_starts_with(card.path(), "card") || !card.is_directory(ec)) {
+				continue;
+			}
+			for (const auto& pcm : fs::directory_iterator {card.path(), ec}) {
+				if (!_is_playback_pcm(pcm.path())) {
+					continue;
+				}
+				for (const auto& sub : fs::directory_iterator {pcm.path(), ec}) {
+					if (!_starts_with(sub.path(), "sub")) {
+						continue;
+					}
+					const int fd = ::open((sub.path() / "status").c_str(), O_RDONLY | O_CLOEXEC);
+					if (fd >= 0) {
+						m_status_fds.push_back(fd);
+					}
+				}
+			}
+		}
+
+		dbg("Found {} audio playback substream(s)\n", m_status_fds.size());
+	}
+
+	void PlaybackMonitor::device_changed() {
+		rescan();
+		m_settle_until = std::chrono::steady_clock::now() + SETTLE_PERIOD;
+	}
+
+	PlaybackMonitor::~PlaybackMonitor() { _close_all(m_status_fds); }
+
+	PlaybackMonitor::PlaybackMonitor(PlaybackMonitor&& other) noexcept
+		: m_root {std::move(other.m_root)},
+		  m_status_fds {std::exchange(other.m_status_fds, {})},
+		  m_settle_until {other.m_settle_until} {}
+
+	PlaybackMonitor& PlaybackMonitor::operator=(PlaybackMonitor&& other) noexcept {
+		if (this != &other) {
+			_close_all(m_status_fds);
+			m_root		   = std::move(other.m_root);
+			m_status_fds   = std::exchange(other.m_status_fds, {});
+			m_settle_until = other.m_settle_until;
+		}
+		return *this;
+	}
+
+	bool PlaybackMonitor::is_playing() {
+		if (std::chrono::steady_clock::now() < m_settle_until) {
+			rescan();
+		}
+
+		// An open substream's status begins with "state: RUNNING" while audio is flowing; a closed one reads "closed".
+		static constexpr std::string_view RUNNING = "state: RUNNING";
+		std::array<char, RUNNING.size()>  buffer;
+
+		for (const int fd : m_status_fds) {
+			const ssize_t n = ::pread(fd, buffer.data(), buffer.size(), 0);
+			if (n == static_cast<ssize_t>(buffer.size()) && std::string_view {buffer.data(), buffer.size()} == RUNNING) {
+				return true;
+			}
+		}
+		return false;
+	}
+} // namespace hermes::media
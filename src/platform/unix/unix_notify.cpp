@@ -0,0 +1,57 @@
+#include "../../pch.h"
+
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <string>
+#include <vector>
+
+#include "../../error.h"
+#include "../../notify.h"
+
+extern char** environ;
+
+namespace hermes::notify {
+	namespace {
+		const char* _urgency_name(const Urgency urgency) {
+			switch (urgency) {
+			case Urgency::low:
+				return "--urgency=low";
+			case Urgency::critical:
+				return "--urgency=critical";
+			default:
+				return "--urgency=normal";
+			}
+		}
+	} // namespace
+
+	bool Notifier::_deliver(const Message& message) {
+		std::vector<char*> argv;
+		for (const std::string& arg : m_command) {
+			argv.push_back(const_cast<char*>(arg.c_str()));
+		}
+		argv.push_back(const_cast<char*>("--app-name=Hermes"));
+		argv.push_back(const_cast<char*>(_urgency_name(message.urgency)));
+		argv.push_back(const_cast<char*>("--"));
+		argv.push_back(const_cast<char*>(message.summary.c_str()));
+		argv.push_back(const_cast<char*>(message.body.c_str()));
+		argv.push_back(nullptr);
+
+		pid_t	  pid;
+		const int errc = ::posix_spawnp(&pid, argv.front(), nullptr, nullptr, argv.data(), environ);
+		if (errc != 0) {
+			return false;
+		}
+
+		int status = 0;
+		while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+		}
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			// The service rejected this one notification; keep trying with later ones
+			error("Failed to show notification '{}'", message.summary);
+		}
+		return true;
+	}
+} // namespace hermes::notify
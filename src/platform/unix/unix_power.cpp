@@ -0,0 +1,160 @@
+#include "../../pch.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "../../error.h"
+#include "../../power.h"
+#include "../../uevent.h"
+
+namespace hermes::power {
+	namespace {
+		constexpr std::string_view PROPERTY_PREFIX = "POWER_SUPPLY_";
+
+		// Attributes that affect the policy; everything else in a supply's directory or uevent is ignored.
+		constexpr std::array<std::string_view, 6> ATTRIBUTES {"type", "scope", "online", "present", "status", "capacity"};
+
+		int _to_int(const std::string_view text, const int fallback) {
+			int value = fallback;
+			std::from_chars(text.data(), text.data() + text.size(), value);
+			return value;
+		}
+
+		std::string _read_attribute(const std::filesystem::path& file) {
+			std::ifstream stream {file};
+			std::string	  value;
+			std::getline(stream, value);
+			return value;
+		}
+	} // namespace
+
+	const std::filesystem::path PowerMonitor::DEFAULT_ROOT {"/sys/class/power_supply"};
+
+	PowerMonitor::PowerMonitor(const Policy policy, const std::filesystem::path& root)
+		: m_policy {policy},
+		  m_root {root} {
+		_read_supplies();
+		dbg("Found {} power supply(s); on battery: {}, battery: {}%\n",
+			m_supplies.size(),
+			on_battery(),
+			battery_percent());
+	}
+
+	bool PowerMonitor::resynchronize() {
+		const bool was_paused = should_pause();
+		_read_supplies();
+		return should_pause() != was_paused;
+	}
+
+	void PowerMonitor::_read_supplies() {
+		m_supplies.clear();
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator {m_root, ec}) {
+			Supply& supply = m_supplies[entry.path().filename().string()];
+			for (const std::string_view attribute : ATTRIBUTES) {
+				const auto file = entry.path() / attribute;
+				if (std::filesystem::exists(file, ec)) {
+					_set_property(supply, attribute, _read_attribute(file));
+				}
+			}
+		}
+	}
+
+	bool PowerMonitor::apply_uevent(const std::string_view message) {
+		const bool was_paused = should_pause();
+
+		const std::string_view action	 = uevent::find(message, "ACTION");
+		const std::string_view subsystem = uevent::find(message, "SUBSYSTEM");
+		const std::string_view name		 = uevent::find(message, "POWER_SUPPLY_NAME");
+		if (subsystem != "power_supply" || name.empty()) {
+			return false;
+		}
+
+		if (action == "remove") {
+			m_supplies.erase(std::string {name});
+			return should_pause() != was_paused;
+		}
+
+		Supply& supply = m_supplies[std::string {name}];
+		uevent::for_each_field(message, [&](const std::string_view field) {
+			const std::size_t equals = field.find('=');
+			if (!field.starts_with(PROPERTY_PREFIX) || equals == std::string_view::npos) {
+				return;
+			}
+
+			// POWER_SUPPLY_CAPACITY=54 -> capacity
+			std::string key {field.substr(PROPERTY_PREFIX.size(), equals - PROPERTY_PREFIX.size())};
+			std::ranges::transform(key, key.begin(), [](unsigned char c) { return std::tolower(c); });
+			_set_property(supply, key, field.substr(equals + 1));
+		});
+
+		return should_pause() != was_paused;
+	}
+
+	void PowerMonitor::_set_property(Supply& supply, const std::string_view key, const std::string_view value) {
+		if (key == "type") {
+			supply.is_battery = value == "Battery";
+		} else if (key == "scope") {
+			supply.is_device = value == "Device";
+		} else if (key == "online") {
+			supply.online = _to_int(value, 0) != 0;
+		} else if (key == "present") {
+			supply.present = _to_int(value, 1) != 0;
+		} else if (key == "status") {
+			supply.discharging = value == "Discharging";
+		} else if (key == "capacity") {
+			supply.capacity = _to_int(value, -1);
+		}
+	}
+
+	bool PowerMonitor::on_battery() const noexcept {
+		bool has_battery	= false;
+		bool discharging	= false;
+		bool has_adapter	= false;
+		bool adapter_online = false;
+		for (const auto& [name, supply] : m_supplies) {
+			if (supply.is_device) {
+				continue;
+			}
+			if (supply.is_battery) {
+				has_battery |= supply.present;
+				discharging |= supply.present && supply.discharging;
+			} else {
+				has_adapter = true;
+				adapter_online |= supply.online;
+			}
+		}
+		// Without an adapter to ask (e.g. some tablets), fall back to the batteries' own status
+		return has_battery && (has_adapter ? !adapter_online : discharging);
+	}
+
+	int PowerMonitor::battery_percent() const noexcept {
+		int lowest = 100;
+		for (const auto& [name, supply] : m_supplies) {
+			if (supply.is_battery && !supply.is_device && supply.present && supply.capacity >= 0) {
+				lowest = std::min(lowest, supply.capacity);
+			}
+		}
+		return lowest;
+	}
+
+	bool PowerMonitor::should_pause() const noexcept {
+		const bool running_on_battery = on_battery();
+		if (m_policy.pause_on_battery && running_on_battery) {
+			return true;
+		}
+		// Some batteries report "Not charging" rather than "Discharging" when the adapter is unplugged
+		return std::ranges::any_of(m_supplies, [&](const auto& entry) {
+			const Supply& supply = entry.second;
+			return supply.is_battery && !supply.is_device && supply.present && supply.capacity >= 0
+				&& supply.capacity <= m_policy.low_battery_percent && (supply.discharging || running_on_battery);
+		});
+	}
+} // namespace hermes::power
@@ -0,0 +1,364 @@
+#include "../../pch.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "../../error.h"
+#include "../../registry.h"
+
+namespace hermes::registry {
+	namespace {
+		constexpr std::uint32_t MAGIC = 0x484d5333; // "HMS3"
+
+		// Slot life cycle: FREE -> CLAIMING -> LIVE -> RETIRING -> FREE. Only the process that wins the CAS into
+		// CLAIMING or RETIRING touches the slot's plain fields, and it names itself in the same CAS: a slot's state
+		// packs, from the low bits up, the phase (2 bits), a generation bumped on every claim (16 bits, so a reaper
+		// that inspected an older occupant cannot retire a newer one), and the owner's PID (22 bits, enough for the
+		// kernel's largest `pid_max`) and PID namespace tag (the low 24 bits of the namespace's inode). The owner of a
+		// LIVE slot is its holder; that of a CLAIMING or RETIRING slot is the process moving it along, and nobody else
+		// may move it until that process has exited.
+		using State = std::uint64_t;
+
+		enum SlotPhase : State {
+			FREE,
+			CLAIMING,
+			LIVE,
+			RETIRING
+		};
+
+		constexpr State PHASE_MASK		= 0b11;
+		constexpr State GENERATION_STEP = State {1} << 2;
+		constexpr State GENERATION_MASK = 0xffff * GENERATION_STEP;
+		constexpr int	PID_SHIFT		= 18;
+		constexpr State PID_MASK		= 0x3fffff;
+		constexpr int	TAG_SHIFT		= 40;
+		constexpr State TAG_MASK		= 0xffffff;
+
+		constexpr State OWNER_MASK		= ~(GENERATION_MASK | PHASE_MASK);
+
+		constexpr SlotPhase _phase(const State state) { return static_cast<SlotPhase>(state & PHASE_MASK); }
+
+		constexpr State _owner_of(const State state) { return state & OWNER_MASK; }
+
+		constexpr pid_t _owner_pid(const State state) { return static_cast<pid_t>((state >> PID_SHIFT) & PID_MASK); }
+
+		constexpr State _owner_tag(const State state) { return (state >> TAG_SHIFT) & TAG_MASK; }
+
+		// Returns `state` moved to `phase` and owned by `owner` (as built by `_owner()`), keeping its generation.
+		constexpr State _transition(const State state, const SlotPhase phase, const State owner) {
+			return (state & GENERATION_MASK) | owner | phase;
+		}
+
+		constexpr State _next_generation(const State state) {
+			return ((state & GENERATION_MASK) + GENERATION_STEP) & GENERATION_MASK;
+		}
+
+		// Returns the kernel start time of `pid` (in clock ticks since boot), 0 if the process has already exited and
+		// is waiting to be reaped by its parent, or nothing if its `/proc` entry cannot be read. That happens when the
+		// process does not exist, but also when /proc is mounted with `hidepid=1` or `hidepid=2` and the process
+		// belongs to another user.
+		std::optional<std::uint64_t> _process_start_time(const pid_t pid) {
+			std::ifstream stat {std::format("/proc/{}/stat", pid)};
+			std::string	  line;
+			if (!std::getline(stat, line)) {
+				return std::nullopt;
+			}
+
+			// The command name may contain spaces and parentheses, so fields are counted from the last ')'. The start
+			// time is field 22; the state (field 3) follows the ')'.
+			auto pos = line.rfind(')');
+			if (pos == std::string::npos || pos + 2 >= line.size()) {
+				return 0;
+			}
+			if (const char state = line[pos + 2]; state == 'Z' || state == 'X') {
+				return 0;
+			}
+			for (int field = 2; field < 22 && pos != std::string::npos; ++field) {
+				pos = line.find(' ', pos + 1);
+			}
+			if (pos == std::string::npos) {
+				return 0;
+			}
+			return std::strtoull(line.c_str() + pos + 1, nullptr, 10);
+		}
+
+		// Returns whether `pid` may still be running. If `start_time` is non-zero, a process that started at another
+		// time is a newer one that reused the PID. Doubtful cases count as alive.
+		bool _process_alive(const pid_t pid, const std::uint64_t start_time = 0) {
+			if (const auto actual = _process_start_time(pid)) {
+				return *actual != 0 && (start_time == 0 || *actual == start_time);
+			}
+			// The /proc entry is missing or hidden from us. `kill()` still tells a missing process from one we may not
+			// signal, though it cannot catch PID reuse.
+			return ::kill(pid, 0) == 0 || errno == EPERM;
+		}
+
+		// Returns the tag of this process's PID namespace: the low bits of its inode. PIDs recorded in the registry
+		// only mean something to processes in the same namespace.
+		State _namespace_tag() {
+			static const State tag = [] {
+				struct stat st {};
+				return ::stat("/proc/self/ns/pid", &st) == 0 ? static_cast<State>(st.st_ino) & TAG_MASK : 0;
+			}();
+			return tag;
+		}
+
+		// Returns the owner bits of a state naming this process. Not cached, since a forked child must not pass for its
+		// parent.
+		State _owner() {
+			return _namespace_tag() << TAG_SHIFT | (static_cast<State>(::getpid()) & PID_MASK) << PID_SHIFT;
+		}
+
+		std::int64_t _now_seconds() {
+			// `steady_clock` is CLOCK_MONOTONIC, which every process on the host shares.
+			using namespace std::chrono;
+			return duration_cast<seconds>(steady_clock::now().time_since_epoch()).count();
+		}
+	} // namespace
+
+	struct InhibitRegistry::Segment {
+		struct Slot {
+			std::atomic<State>			  state;
+			std::atomic<std::uint32_t>	  refs;
+			std::uint64_t				  start_time; // of the holder, or 0 if unknown
+			std::int64_t				  expiry; // 0 if the hold never lapses
+			std::array<char, REASON_SIZE> reason;
+		};
+
+		std::atomic<std::uint32_t> magic;
+		std::atomic<std::int32_t>  live;
+		std::array<Slot, CAPACITY> slots;
+
+		// The segment is writable by every user, so nothing in it is trusted blindly: `reap()` recounts `live` from
+		// the slots and frees slots whose owner exited mid-transition.
+		//
+		// A freshly created segment is zero-filled, which is already a valid empty table.
+		static_assert(_phase(0) == FREE);
+		static_assert(std::atomic<State>::is_always_lock_free);
+		static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+		static_assert(std::atomic<std::int32_t>::is_always_lock_free);
+	};
+
+	namespace {
+		using Segment = InhibitRegistry::Segment;
+	}
+
+	InhibitRegistry::InhibitRegistry(const std::string& name) {
+		dbg("Opening inhibit registry '{}'...", name);
+		const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+		if (!dbg_validate(fd >= 0)) {
+			throw std::system_error(errno, std::generic_category(), "Failed to open inhibit registry");
+		}
+		// The segment is shared by every user on the host, so the creator's umask must not narrow its mode.
+		::fchmod(fd, 0666);
+
+		struct stat st {};
+		const bool	sized = ::fstat(fd, &st) == 0
+			&& (st.st_size >= static_cast<off_t>(sizeof(Segment)) || ::ftruncate(fd, sizeof(Segment)) == 0);
+		if (!sized) {
+			const int errc = errno;
+			::close(fd);
+			throw std::system_error(errc, std::generic_category(), "Failed to size inhibit registry");
+		}
+
+		void* address = ::mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (address == MAP_FAILED) {
+			throw std::system_error(errno, std::generic_category(), "Failed to map inhibit registry");
+		}
+		m_segment = static_cast<Segment*>(address);
+
+		std::uint32_t magic = 0;
+		if (!m_segment->magic.compare_exchange_strong(magic, MAGIC) && magic != MAGIC) {
+			::munmap(m_segment, sizeof(Segment));
+			m_segment = nullptr;
+			throw std::system_error(
+				std::make_error_code(std::errc::wrong_protocol_type), "Inhibit registry has an incompatible layout");
+		}
+	}
+
+	InhibitRegistry::~InhibitRegistry() {
+		if (m_segment) {
+			::munmap(m_segment, sizeof(Segment));
+		}
+	}
+
+	InhibitRegistry::InhibitRegistry(InhibitRegistry&& other) noexcept
+		: m_segment {std::exchange(other.m_segment, nullptr)},
+		  m_miscount {other.m_miscount} {}
+
+	InhibitRegistry& InhibitRegistry::operator=(InhibitRegistry&& other) noexcept {
+		if (this != &other) {
+			if (m_segment) {
+				::munmap(m_segment, sizeof(Segment));
+			}
+			m_segment  = std::exchange(other.m_segment, nullptr);
+			m_miscount = other.m_miscount;
+		}
+		return *this;
+	}
+
+	namespace {
+		// Returns the slot's state if it is a LIVE hold of `owner` for `reason`, and 0 otherwise. Anyone may write the
+		// reason, so it is not trusted to be terminated.
+		State _own_slot_state(const Segment::Slot& slot, const State owner, const std::string_view reason) {
+			const State			   state  = slot.state.load(std::memory_order_acquire);
+			const std::string_view stored = {slot.reason.data(), ::strnlen(slot.reason.data(), slot.reason.size())};
+			const bool			   owned  = _phase(state) == LIVE && _owner_of(state) == owner && stored == reason;
+			return owned ? state : 0;
+		}
+
+		// Moves a slot observed as LIVE with `state` to FREE. Only the caller whose CAS succeeds adjusts the live
+		// counter, and the slot stays its own until it is freed.
+		bool _retire(Segment& segment, Segment::Slot& slot, State state) {
+			const State retiring = _transition(state, RETIRING, _owner());
+			if (!slot.state.compare_exchange_strong(state, retiring, std::memory_order_acq_rel)) {
+				return false;
+			}
+			segment.live.fetch_sub(1, std::memory_order_release);
+			slot.refs.store(0, std::memory_order_relaxed);
+			slot.state.store(_transition(retiring, FREE, 0), std::memory_order_release);
+			return true;
+		}
+
+		// Returns whether the holder of a slot observed as LIVE with `state` may still be running. Doubtful cases count
+		// as alive: a hold kept too long ends at its expiry or when its owner releases it, while one retired too early
+		// lets the screensaver come back under a running holder.
+		bool _holder_alive(const Segment::Slot& slot, const State state) {
+			// Holders in another PID namespace are left to their expiry and to reapers in their own namespace.
+			return _owner_tag(state) != _namespace_tag() || _process_alive(_owner_pid(state), slot.start_time);
+		}
+	} // namespace
+
+	bool InhibitRegistry::acquire(const std::string_view reason, const std::chrono::seconds ttl) {
+		const State owner = _owner();
+
+		for (auto& slot : m_segment->slots) {
+			if (_own_slot_state(slot, owner, reason)) {
+				slot.refs.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		for (auto& slot : m_segment->slots) {
+			State state = slot.state.load(std::memory_order_relaxed);
+			if (_phase(state) != FREE) {
+				continue;
+			}
+			const State claimed = _transition(_next_generation(state), CLAIMING, owner);
+			if (!slot.state.compare_exchange_strong(state, claimed, std::memory_order_acquire)) {
+				continue;
+			}
+
+			slot.start_time = _process_start_time(::getpid()).value_or(0);
+			slot.expiry		= ttl == std::chrono::seconds::zero() ? 0 : _now_seconds() + ttl.count();
+			slot.reason.fill('\0');
+			reason.copy(slot.reason.data(), std::min(reason.size(), REASON_SIZE - 1));
+			slot.refs.store(1, std::memory_order_relaxed);
+
+			// Count the holder before publishing it so that a concurrent reaper can never drive the counter negative.
+			m_segment->live.fetch_add(1, std::memory_order_relaxed);
+			slot.state.store(_transition(claimed, LIVE, owner), std::memory_order_release);
+			return true;
+		}
+
+		return false;
+	}
+
+	void InhibitRegistry::release(const std::string_view reason) {
+		const State owner = _owner();
+
+		for (auto& slot : m_segment->slots) {
+			if (const State state = _own_slot_state(slot, owner, reason)) {
+				if (slot.refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					_retire(*m_segment, slot, state);
+				}
+				return;
+			}
+		}
+	}
+
+	bool InhibitRegistry::any_live_holder() const noexcept {
+		return m_segment->live.load(std::memory_order_acquire) > 0;
+	}
+
+	std::size_t InhibitRegistry::reap() {
+		const std::int64_t now		   = _now_seconds();
+		const std::int32_t live_before = m_segment->live.load(std::memory_order_acquire);
+		std::size_t		   reaped	   = 0;
+		std::int32_t	   retired	   = 0; // LIVE slots retired by this scan
+		std::int32_t	   counted	   = 0; // LIVE slots left after this scan
+		bool			   settled	   = true;
+
+		for (auto& slot : m_segment->slots) {
+			State state = slot.state.load(std::memory_order_acquire);
+
+			switch (_phase(state)) {
+			case FREE: break;
+			case CLAIMING:
+			case RETIRING:
+				// Only the owner may move the slot on, so it is freed only once the owner has exited: one that is
+				// merely stalled would otherwise write into the slot's next occupant. Owners in another PID namespace
+				// are left to reapers in their own namespace.
+				if (_owner_tag(state) == _namespace_tag() && !_process_alive(_owner_pid(state))
+					&& slot.state.compare_exchange_strong(
+						state, _transition(state, FREE, 0), std::memory_order_acq_rel)) {
+					++reaped;
+				} else {
+					settled = false;
+				}
+				break;
+			case LIVE: {
+				const bool expired = slot.expiry != 0 && slot.expiry <= now;
+				if ((expired || !_holder_alive(slot, state)) && _retire(*m_segment, slot, state)) {
+					++reaped;
+					++retired;
+				} else {
+					++counted;
+				}
+				break;
+			}
+			}
+		}
+
+		// Repair the live counter if it disagrees with the slots. A process that died between counting and publishing
+		// (or between retiring and uncounting) leaves it off by one for good, and so does anyone scribbling on the
+		// segment. The recount is only trusted if nothing was mid-transition and the counter only moved by our own
+		// retirements, and a discrepancy must survive two reaps before it is acted on, so a claim and a release that
+		// overlap the scan cannot fool it.
+		const std::int32_t live_after = m_segment->live.load(std::memory_order_acquire);
+		const bool		   trusted	  = settled && live_before - retired == live_after;
+		if (!trusted || live_after == counted) {
+			m_miscount.reset();
+		} else if (m_miscount != std::pair {live_after, counted}) {
+			m_miscount = {live_after, counted};
+		} else {
+			std::int32_t expected = live_after;
+			if (m_segment->live.compare_exchange_strong(expected, counted, std::memory_order_acq_rel)) {
+				error("Repaired inhibit registry live count ({} -> {})", live_after, counted);
+			}
+			m_miscount.reset();
+		}
+
+		if (reaped) {
+			dbg("Reaped {} stale inhibit registry slot(s)\n", reaped);
+		}
+		return reaped;
+	}
+} // namespace hermes::registry
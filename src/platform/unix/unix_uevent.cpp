@@ -0,0 +1,79 @@
+#include "../../pch.h"
+
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include "../../error.h"
+#include "../../notify.h"
+#include "../../uevent.h"
+
+namespace hermes::uevent {
+	Listener::Listener() {
+		dbg("Subscribing to kernel uevents...");
+		m_socket = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+
+		// Group 1 carries the kernel's own uevents (group 2 is udevd's rebroadcast).
+		sockaddr_nl address {};
+		address.nl_family = AF_NETLINK;
+		address.nl_groups = 1;
+		if (m_socket >= 0 && ::bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+			const int errc = errno;
+			::close(m_socket);
+			m_socket = -1;
+			errno	 = errc;
+		}
+
+		if (!dbg_validate(m_socket >= 0)) {
+			error("Failed to subscribe to kernel uevents: {}", std::strerror(errno));
+			notify::send("Device monitoring failed", "Sleep will not follow power or audio device changes");
+		}
+	}
+
+	Listener::~Listener() {
+		if (m_socket >= 0) {
+			::close(m_socket);
+		}
+	}
+
+	bool Listener::dispatch(const Handler& handler) {
+		if (m_socket < 0) {
+			return true;
+		}
+
+		bool				   complete = true;
+		std::array<char, 8192> buffer;
+		for (;;) {
+			sockaddr_nl sender {};
+			iovec		io {buffer.data(), buffer.size()};
+			msghdr		header {};
+			header.msg_name	   = &sender;
+			header.msg_namelen = sizeof(sender);
+			header.msg_iov	   = &io;
+			header.msg_iovlen  = 1;
+
+			const ssize_t n = ::recvmsg(m_socket, &header, 0);
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				if (errno == ENOBUFS) {
+					complete = false;
+					continue;
+				}
+				break; // EAGAIN: nothing left to read
+			}
+
+			// Only trust messages sent by the kernel itself
+			if (sender.nl_pid != 0 || (header.msg_flags & MSG_TRUNC)) {
+				continue;
+			}
+			handler({buffer.data(), static_cast<std::size_t>(n)});
+		}
+		return complete;
+	}
+} // namespace hermes::uevent
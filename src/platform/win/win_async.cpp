@@ -0,0 +1,34 @@
+#include "../../pch.h"
+
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include "../../async.h"
+
+namespace hermes::async {
+	// Windows has no epoll; the reactor sleeps between iterations and only supports timers and posted work.
+	Reactor::Reactor() = default;
+
+	Reactor::~Reactor() { _destroy_waiters(); }
+
+	void Reactor::_watch(const int fd) {
+		m_fd_waiters.erase(fd);
+		throw std::system_error(
+			std::make_error_code(std::errc::function_not_supported),
+			"Waiting on descriptors is not supported on Windows");
+	}
+
+	void Reactor::_wake() {}
+
+	std::size_t Reactor::_wait(const clock_t::duration timeout) {
+		{
+			std::lock_guard lock {m_posted_mutex};
+			if (!m_posted.empty()) {
+				return 0;
+			}
+		}
+		std::this_thread::sleep_for(timeout);
+		return 0;
+	}
+} // namespace hermes::async
@@ -0,0 +1,20 @@
+#include "../../pch.h"
+
+#include <utility>
+
+#include "../../focus.h"
+
+namespace hermes::focus {
+	// Focus tracking is not implemented on Windows; the watcher is always inactive.
+	FocusWatcher::FocusWatcher(std::vector<Rule> rules, const char*) : m_rules {std::move(rules)} {}
+
+	FocusWatcher::~FocusWatcher() = default;
+
+	int FocusWatcher::fd() const noexcept { return -1; }
+
+	bool FocusWatcher::dispatch() { return false; }
+
+	void FocusWatcher::_update_active_window() {}
+
+	bool FocusWatcher::_window_matches(unsigned long) { return false; }
+} // namespace hermes::focus
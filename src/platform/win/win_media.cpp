@@ -0,0 +1,33 @@
+#include "../../pch.h"
+
+#include <filesystem>
+#include <utility>
+
+#include "../../media.h"
+
+namespace hermes::media {
+	// Playback detection is not implemented on Windows; the monitor never reports any devices.
+	bool is_device_event(std::string_view) { return false; }
+
+	const std::filesystem::path PlaybackMonitor::DEFAULT_ROOT {};
+
+	PlaybackMonitor::PlaybackMonitor(const std::filesystem::path& root) : m_root {root} {}
+
+	PlaybackMonitor::~PlaybackMonitor() = default;
+
+	PlaybackMonitor::PlaybackMonitor(PlaybackMonitor&& other) noexcept
+		: m_root {std::move(other.m_root)},
+		  m_status_fds {std::exchange(other.m_status_fds, {})} {}
+
+	PlaybackMonitor& PlaybackMonitor::operator=(PlaybackMonitor&& other) noexcept {
+		m_root		 = std::move(other.m_root);
+		m_status_fds = std::exchange(other.m_status_fds, {});
+		return *this;
+	}
+
+	void PlaybackMonitor::rescan() {}
+
+	void PlaybackMonitor::device_changed() {}
+
+	bool PlaybackMonitor::is_playing() { return false; }
+} // namespace hermes::media
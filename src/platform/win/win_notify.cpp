@@ -0,0 +1,8 @@
+#include "../../pch.h"
+
+#include "../../notify.h"
+
+namespace hermes::notify {
+	// Desktop notifications are not implemented on Windows; the notifier falls back to logging.
+	bool Notifier::_deliver(const Message&) { return false; }
+} // namespace hermes::notify
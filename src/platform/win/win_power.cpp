@@ -0,0 +1,28 @@
+#include "../../pch.h"
+
+#include <filesystem>
+
+#include "../../power.h"
+
+namespace hermes::power {
+	// Power source monitoring is not implemented on Windows; the monitor never asks for inhibition to be paused.
+	const std::filesystem::path PowerMonitor::DEFAULT_ROOT {};
+
+	PowerMonitor::PowerMonitor(const Policy policy, const std::filesystem::path& root)
+		: m_policy {policy},
+		  m_root {root} {}
+
+	bool PowerMonitor::apply_uevent(std::string_view) { return false; }
+
+	bool PowerMonitor::resynchronize() { return false; }
+
+	void PowerMonitor::_read_supplies() {}
+
+	void PowerMonitor::_set_property(Supply&, std::string_view, std::string_view) {}
+
+	bool PowerMonitor::should_pause() const noexcept { return false; }
+
+	bool PowerMonitor::on_battery() const noexcept { return false; }
+
+	int PowerMonitor::battery_percent() const noexcept { return 100; }
+} // namespace hermes::power
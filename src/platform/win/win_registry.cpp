@@ -0,0 +1,35 @@
+#include "../../pch.h"
+
+#include <system_error>
+#include <utility>
+
+#include "../../registry.h"
+
+namespace hermes::registry {
+	// The host-wide registry is not implemented on Windows; opening it always fails and callers fall back to
+	// process-local inhibition.
+	struct InhibitRegistry::Segment {};
+
+	InhibitRegistry::InhibitRegistry(const std::string&) {
+		throw std::system_error(
+			std::make_error_code(std::errc::function_not_supported), "Inhibit registry is not supported on Windows");
+	}
+
+	InhibitRegistry::~InhibitRegistry() = default;
+
+	InhibitRegistry::InhibitRegistry(InhibitRegistry&& other) noexcept
+		: m_segment {std::exchange(other.m_segment, nullptr)} {}
+
+	InhibitRegistry& InhibitRegistry::operator=(InhibitRegistry&& other) noexcept {
+		m_segment = std::exchange(other.m_segment, nullptr);
+		return *this;
+	}
+
+	bool InhibitRegistry::acquire(std::string_view, std::chrono::seconds) { return false; }
+
+	void InhibitRegistry::release(std::string_view) {}
+
+	bool InhibitRegistry::any_live_holder() const noexcept { return false; }
+
+	std::size_t InhibitRegistry::reap() { return 0; }
+} // namespace hermes::registry
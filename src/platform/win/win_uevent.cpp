@@ -0,0 +1,12 @@
+#include "../../pch.h"
+
+#include "../../uevent.h"
+
+namespace hermes::uevent {
+	// Windows has no uevents; the listener never opens.
+	Listener::Listener() = default;
+
+	Listener::~Listener() = default;
+
+	bool Listener::dispatch(const Handler&) { return true; }
+} // namespace hermes::uevent
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace hermes::power {
+	// When inhibition should be paused to save power.
+	struct Policy {
+		// Pause while running on battery.
+		bool pause_on_battery = true;
+		// Pause while any battery powering the machine is draining and at or below this charge (in percent). This
+		// applies even when `pause_on_battery` is off, and also when an adapter is plugged in but too weak to keep the
+		// battery from draining. A negative value disables it.
+		int low_battery_percent = 10;
+	};
+
+	// Tracks the machine's power sources.
+	//
+	// `/sys/class/power_supply/*` is read once on construction. After that the monitor only reacts to the kernel's
+	// `power_supply` uevents (see `uevent::Listener`); sysfs is only read again if uevents were lost.
+	class PowerMonitor {
+	public:
+		static const std::filesystem::path DEFAULT_ROOT;
+
+		// Reads the initial state from `root`.
+		explicit PowerMonitor(Policy policy = {}, const std::filesystem::path& root = DEFAULT_ROOT);
+
+		// Handles one raw uevent message; messages for other subsystems are ignored. Returns `true` if `should_pause()`
+		// changed.
+		bool apply_uevent(std::string_view message);
+
+		// Re-reads every supply from sysfs. Returns `true` if `should_pause()` changed.
+		bool resynchronize();
+
+		// Returns `true` if the policy says inhibition should currently be paused.
+		[[nodiscard]] bool should_pause() const noexcept;
+
+		// Returns `true` if the machine is running from a battery.
+		[[nodiscard]] bool on_battery() const noexcept;
+
+		// Returns the lowest charge among present batteries (in percent), or 100 if there are none.
+		[[nodiscard]] int battery_percent() const noexcept;
+	private:
+		struct Supply {
+			bool is_battery	 = false;
+			bool is_device	 = false; // powers a peripheral (e.g. a wireless mouse), not the machine
+			bool online		 = false; // adapters only
+			bool present	 = true;  // batteries only
+			bool discharging = false; // batteries only
+			int	 capacity	 = -1;	  // batteries only; -1 if unknown
+		};
+
+		Policy						  m_policy;
+		std::filesystem::path		  m_root;
+		std::map<std::string, Supply> m_supplies;
+
+		// Replaces the known supplies with what is currently in sysfs.
+		void _read_supplies();
+
+		// Applies one attribute, named as in sysfs (`type`, `online`, `capacity`...), to `supply`.
+		static void _set_property(Supply& supply, std::string_view key, std::string_view value);
+	};
+} // namespace hermes::power
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace hermes::registry {
+	// A host-wide table of processes that want the display kept awake, stored in a small shared-memory segment so that
+	// every Hermes instance (and any other tool that opens the segment) agrees on whether the screensaver may come back.
+	//
+	// Slots are claimed and retired with compare-and-swap only; no lock is ever held. Each slot records its owner's PID,
+	// PID namespace and start time (to survive PID reuse), an optional expiry and a short reason. Holds taken twice by
+	// the same process for the same reason share one reference-counted slot. Slots whose owner has exited or whose
+	// expiry has passed are reclaimed by `reap()`, which any process may call.
+	//
+	// Liveness is judged from `/proc`, so it is only as good as what this process can see there. When a holder's
+	// `/proc` entry is hidden (`hidepid=`) it is presumed alive while `kill(pid, 0)` finds it, even if the PID has been
+	// reused, and holders in another PID namespace are never judged at all. Holds that must not outlive a crash in
+	// those setups should pass a `ttl`. A slot caught mid-claim or mid-release is only freed once the process moving
+	// it has exited, so a stopped process keeps its slot until it is resumed or killed.
+	class InhibitRegistry {
+	public:
+		static constexpr const char* DEFAULT_NAME = "/hermes-inhibit";
+		static constexpr std::size_t CAPACITY	  = 256;
+		static constexpr std::size_t REASON_SIZE  = 48;
+
+		// Layout of the shared-memory segment; opaque outside the platform implementation.
+		struct Segment;
+
+		// Opens (creating it if needed) the shared-memory segment called `name`. Throws `std::system_error` on failure.
+		explicit InhibitRegistry(const std::string& name = DEFAULT_NAME);
+
+		~InhibitRegistry();
+		InhibitRegistry(const InhibitRegistry&)			   = delete;
+		InhibitRegistry& operator=(const InhibitRegistry&) = delete;
+		InhibitRegistry(InhibitRegistry&& other) noexcept;
+		InhibitRegistry& operator=(InhibitRegistry&& other) noexcept;
+
+		// Takes a hold for `reason` on behalf of this process. If `ttl` is non-zero the hold lapses after that long.
+		// Returns `false` if every slot is taken.
+		bool acquire(std::string_view reason, std::chrono::seconds ttl = std::chrono::seconds::zero());
+
+		// Drops one reference to this process's hold for `reason`, retiring the slot when none remain.
+		void release(std::string_view reason);
+
+		// Returns `true` if any process holds the registry. Runs in constant time.
+		[[nodiscard]] bool any_live_holder() const noexcept;
+
+		// Retires slots whose owner has exited or whose expiry has passed, frees slots left mid-claim or mid-release by
+		// a process that has exited, and repairs the live-holder count if it has drifted from the slots. Returns the
+		// number of slots freed. Meant to be called periodically; a drifted count needs two calls to be repaired.
+		std::size_t reap();
+	private:
+		Segment* m_segment = nullptr;
+
+		// The (counter, recount) mismatch seen by the previous `reap()`, if any.
+		std::optional<std::pair<std::int32_t, std::int32_t>> m_miscount;
+	};
+} // namespace hermes::registry
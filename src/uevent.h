@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace hermes::uevent {
+	// Calls `fn` with each NUL-separated field of a uevent message (`ACTION@DEVPATH` followed by `KEY=VALUE` pairs).
+	template<class Fn>
+	void for_each_field(const std::string_view message, Fn&& fn) {
+		std::size_t begin = 0;
+		while (begin < message.size()) {
+			const std::size_t end = std::min(message.find('\0', begin), message.size());
+			fn(message.substr(begin, end - begin));
+			begin = end + 1;
+		}
+	}
+
+	// Returns the value of `key` in a uevent message, or an empty string if it is absent.
+	[[nodiscard]] inline std::string_view find(const std::string_view message, const std::string_view key) {
+		std::string_view value;
+		for_each_field(message, [&](const std::string_view field) {
+			if (field.size() > key.size() && field.starts_with(key) && field[key.size()] == '=') {
+				value = field.substr(key.size() + 1);
+			}
+		});
+		return value;
+	}
+
+	// Receives the kernel's device events on a non-blocking netlink socket. Only messages sent by the kernel itself are
+	// passed on. On Windows the listener never opens.
+	class Listener {
+	public:
+		using Handler = std::function<void(std::string_view message)>;
+
+		// Subscribes to kernel uevents; failure is reported and leaves the listener closed.
+		Listener();
+
+		~Listener();
+		Listener(const Listener&)			 = delete;
+		Listener& operator=(const Listener&) = delete;
+		Listener(Listener&&)				 = delete;
+		Listener& operator=(Listener&&)		 = delete;
+
+		// Returns the socket, or -1 if the listener is closed.
+		[[nodiscard]] int fd() const noexcept { return m_socket; }
+
+		// Passes every pending message to `handler` without blocking. Returns `false` if the kernel dropped messages
+		// since the last call, in which case receivers should re-read whatever state they track.
+		bool dispatch(const Handler& handler);
+	private:
+		int m_socket = -1;
+	};
+} // namespace hermes::uevent
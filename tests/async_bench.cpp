@@ -0,0 +1,141 @@
+#include "pch.h"
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <vector>
+
+#include "async.h"
+
+// Measures the reactor's per-event overhead and how often an idle main loop wakes up as background sources are added.
+// Not run by ctest; build the `async_bench` target and run it directly (ideally from a Release build).
+
+using hermes::async::Reactor;
+using hermes::async::Task;
+using namespace std::chrono_literals;
+
+namespace {
+	using clock_t = std::chrono::steady_clock;
+
+	constexpr std::size_t ITERATIONS = 100'000;
+
+	// Mirrors Hermes' main loop: every wait is bounded by the SDL pump interval.
+	constexpr auto PUMP_INTERVAL = 100ms;
+
+	std::chrono::nanoseconds cpu_time() {
+		timespec time {};
+		::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+		return std::chrono::seconds {time.tv_sec} + std::chrono::nanoseconds {time.tv_nsec};
+	}
+
+	Task drain_pipe(Reactor& reactor, const int fd, std::size_t& events) {
+		for (;;) {
+			co_await reactor.readable(fd);
+			char byte;
+			while (::read(fd, &byte, 1) == 1) {}
+			++events;
+		}
+	}
+
+	Task hop(Reactor& reactor, std::size_t& hops) {
+		while (hops < ITERATIONS) {
+			co_await reactor.schedule();
+			++hops;
+		}
+	}
+
+	// A background source that polls on a timer, like `poll_sources()`.
+	Task poll_forever(Reactor& reactor, const clock_t::duration interval) {
+		for (;;) {
+			co_await reactor.sleep_for(interval);
+		}
+	}
+
+	// A background source that waits on a descriptor that never becomes readable, like `watch_uevents()` on a quiet
+	// system.
+	Task wait_forever(Reactor& reactor, const int fd) { co_await reactor.readable(fd); }
+
+	void bench_fd_events() {
+		Reactor			   reactor;
+		std::array<int, 2> pipe_fds {};
+		[[maybe_unused]] const int piped = ::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC);
+
+		std::size_t events = 0;
+		drain_pipe(reactor, pipe_fds[0], events);
+
+		const auto start = clock_t::now();
+		for (std::size_t i = 0; i < ITERATIONS; ++i) {
+			[[maybe_unused]] const auto written = ::write(pipe_fds[1], "x", 1);
+			reactor.run_once(PUMP_INTERVAL);
+		}
+		const auto elapsed = clock_t::now() - start;
+		std::println(
+			"fd event (write, wait, resume): {:.2f} us/event over {} events",
+			std::chrono::duration<double, std::micro>(elapsed).count() / events,
+			events);
+
+		::close(pipe_fds[0]);
+		::close(pipe_fds[1]);
+	}
+
+	void bench_schedule() {
+		Reactor		reactor;
+		std::size_t hops = 0;
+		hop(reactor, hops);
+
+		const auto start = clock_t::now();
+		while (hops < ITERATIONS) {
+			reactor.run_once(PUMP_INTERVAL);
+		}
+		const auto elapsed = clock_t::now() - start;
+		const double per_hop = std::chrono::duration<double, std::micro>(elapsed).count() / hops;
+		std::println("schedule() hop: {:.2f} us/hop", per_hop);
+	}
+
+	// Runs an idle loop for one second with `sources` timer tasks and as many descriptor waits.
+	void bench_idle(const std::size_t sources) {
+		Reactor			 reactor;
+		std::vector<int> fds;
+		for (std::size_t i = 0; i < sources; ++i) {
+			std::array<int, 2> pipe_fds {};
+			if (::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC) != 0) {
+				break;
+			}
+			fds.insert(fds.end(), pipe_fds.begin(), pipe_fds.end());
+			poll_forever(reactor, 2s);
+			wait_forever(reactor, pipe_fds[0]);
+		}
+
+		std::size_t wakeups	  = 0;
+		const auto	cpu_start = cpu_time();
+		const auto	deadline  = clock_t::now() + 1s;
+		while (clock_t::now() < deadline) {
+			reactor.run_once(PUMP_INTERVAL);
+			++wakeups;
+		}
+		const auto cpu = cpu_time() - cpu_start;
+		std::println(
+			"idle, {:4} timer + {:4} fd sources: {} wake-ups/s, {:.2f} ms CPU/s",
+			sources,
+			sources,
+			wakeups,
+			std::chrono::duration<double, std::milli>(cpu).count());
+
+		for (const int fd : fds) {
+			::close(fd);
+		}
+	}
+} // namespace
+
+int main() {
+	bench_fd_events();
+	bench_schedule();
+	for (const std::size_t sources : {0, 10, 100, 500}) {
+		bench_idle(sources);
+	}
+}
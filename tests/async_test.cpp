@@ -0,0 +1,139 @@
+#include "pch.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async.h"
+#include "test.h"
+
+using hermes::async::Reactor;
+using hermes::async::Task;
+using namespace std::chrono_literals;
+
+namespace {
+	// Sets a flag when destroyed, so a test can tell whether a suspended coroutine's frame was freed.
+	struct DestroyFlag {
+		bool& destroyed;
+
+		~DestroyFlag() { destroyed = true; }
+	};
+
+	Task wait_readable(Reactor& reactor, const int fd, int& wakeups, bool& destroyed) {
+		DestroyFlag flag {destroyed};
+		for (;;) {
+			co_await reactor.readable(fd);
+			char byte;
+			while (::read(fd, &byte, 1) == 1) {}
+			++wakeups;
+		}
+	}
+
+	Task sleep_then_record(Reactor& reactor, std::chrono::milliseconds delay, std::vector<int>& order, const int id) {
+		co_await reactor.sleep_for(delay);
+		order.push_back(id);
+	}
+
+	Task move_to_reactor(Reactor& reactor, std::optional<std::thread::id>& resumed_on, bool& destroyed) {
+		DestroyFlag flag {destroyed};
+		co_await reactor.schedule();
+		resumed_on = std::this_thread::get_id();
+	}
+
+	Task sleep_forever(Reactor& reactor, bool& destroyed) {
+		DestroyFlag flag {destroyed};
+		co_await reactor.sleep_for(24h);
+	}
+
+	void test_readable() {
+		Reactor			   reactor;
+		std::array<int, 2> pipe_fds {};
+		CHECK(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC) == 0);
+
+		int	 wakeups   = 0;
+		bool destroyed = false;
+		wait_readable(reactor, pipe_fds[0], wakeups, destroyed);
+		CHECK(reactor.run_once(0ms) == 0);
+
+		for (int i = 1; i <= 3; ++i) {
+			CHECK(::write(pipe_fds[1], "xy", 2) == 2);
+			CHECK(reactor.run_once(1s) == 1);
+			CHECK(wakeups == i);
+		}
+		CHECK(reactor.run_once(0ms) == 0);
+
+		::close(pipe_fds[1]);
+		::close(pipe_fds[0]);
+	}
+
+	void test_timers() {
+		Reactor			 reactor;
+		std::vector<int> order;
+		sleep_then_record(reactor, 30ms, order, 3);
+		sleep_then_record(reactor, 10ms, order, 1);
+		sleep_then_record(reactor, 20ms, order, 2);
+		sleep_then_record(reactor, 20ms, order, 22); // equal deadlines keep their order
+
+		const auto deadline = std::chrono::steady_clock::now() + 1s;
+		while (order.size() < 4 && std::chrono::steady_clock::now() < deadline) {
+			reactor.run_once(1s);
+		}
+		CHECK(order == std::vector {1, 2, 22, 3});
+	}
+
+	void test_cross_thread() {
+		Reactor							reactor;
+		int								posted = 0;
+		std::optional<std::thread::id>	resumed_on;
+		bool							destroyed = false;
+
+		std::thread {[&] {
+			reactor.post([&] { ++posted; });
+			move_to_reactor(reactor, resumed_on, destroyed);
+		}}.join();
+		CHECK(!resumed_on);
+
+		CHECK(reactor.run_once(1s) == 2);
+		CHECK(posted == 1);
+		CHECK(resumed_on == std::this_thread::get_id());
+		CHECK(destroyed);
+	}
+
+	// Coroutines still suspended on a reactor are destroyed with it, whatever they wait on.
+	void test_destroy_waiters() {
+		std::array<int, 2> pipe_fds {};
+		CHECK(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC) == 0);
+
+		int								wakeups = 0;
+		bool							fd_destroyed = false, timer_destroyed = false, scheduled_destroyed = false;
+		std::optional<std::thread::id>	resumed_on;
+		{
+			Reactor reactor;
+			wait_readable(reactor, pipe_fds[0], wakeups, fd_destroyed);
+			sleep_forever(reactor, timer_destroyed);
+			move_to_reactor(reactor, resumed_on, scheduled_destroyed);
+			CHECK(!fd_destroyed && !timer_destroyed && !scheduled_destroyed);
+		}
+		CHECK(fd_destroyed);
+		CHECK(timer_destroyed);
+		CHECK(scheduled_destroyed);
+		CHECK(!resumed_on);
+
+		::close(pipe_fds[1]);
+		::close(pipe_fds[0]);
+	}
+} // namespace
+
+int main() {
+	test_readable();
+	test_timers();
+	test_cross_thread();
+	test_destroy_waiters();
+	return hermes::test::result();
+}
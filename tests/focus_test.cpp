@@ -0,0 +1,248 @@
+#include "pch.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "focus.h"
+#include "test.h"
+
+using hermes::focus::FocusWatcher;
+using hermes::focus::parse_rules;
+using namespace std::chrono_literals;
+
+extern char** environ;
+
+namespace {
+	constexpr int SKIP = 77; // ctest's SKIP_RETURN_CODE
+
+	// A private X server on a display number it picks itself.
+	class Xvfb {
+	public:
+		// Returns nothing if Xvfb is not installed or does not start.
+		static std::optional<Xvfb> start() {
+			int pipe_fds[2];
+			if (::pipe(pipe_fds) != 0) {
+				return std::nullopt;
+			}
+
+			// `-displayfd` makes Xvfb pick a free display and write its number once it accepts connections
+			const std::string  display_fd = std::to_string(pipe_fds[1]);
+			std::vector<char*> argv {
+				const_cast<char*>("Xvfb"),
+				const_cast<char*>("-displayfd"),
+				const_cast<char*>(display_fd.c_str()),
+				const_cast<char*>("-nolisten"),
+				const_cast<char*>("tcp"),
+				const_cast<char*>("-screen"),
+				const_cast<char*>("0"),
+				const_cast<char*>("320x240x24"),
+				nullptr};
+
+			pid_t	  pid;
+			const int errc = ::posix_spawnp(&pid, argv.front(), nullptr, nullptr, argv.data(), environ);
+			::close(pipe_fds[1]);
+			if (errc != 0) {
+				::close(pipe_fds[0]);
+				return std::nullopt;
+			}
+
+			std::string number;
+			pollfd		readable {pipe_fds[0], POLLIN, 0};
+			char		c;
+			while (::poll(&readable, 1, 5000) > 0 && ::read(pipe_fds[0], &c, 1) == 1 && c != '\n') {
+				number += c;
+			}
+			::close(pipe_fds[0]);
+
+			Xvfb server {pid, ":" + number};
+			if (number.empty()) {
+				return std::nullopt;
+			}
+			return server;
+		}
+
+		~Xvfb() {
+			if (m_pid > 0) {
+				::kill(m_pid, SIGTERM);
+				::waitpid(m_pid, nullptr, 0);
+			}
+		}
+
+		Xvfb(Xvfb&& other) noexcept : m_pid {std::exchange(other.m_pid, 0)}, m_display {std::move(other.m_display)} {}
+		Xvfb& operator=(Xvfb&&) = delete;
+
+		[[nodiscard]] const char* display() const noexcept { return m_display.c_str(); }
+	private:
+		pid_t		m_pid;
+		std::string m_display;
+
+		Xvfb(const pid_t pid, std::string display) : m_pid {pid}, m_display {std::move(display)} {}
+	};
+
+	// Plays the window manager and the applications: creates windows, names them and moves the focus.
+	class Desktop {
+	public:
+		explicit Desktop(const char* display_name) : m_display {XOpenDisplay(display_name)} {
+			m_root				 = DefaultRootWindow(m_display);
+			m_active_window_atom = XInternAtom(m_display, "_NET_ACTIVE_WINDOW", False);
+			m_pid_atom			 = XInternAtom(m_display, "_NET_WM_PID", False);
+		}
+
+		~Desktop() { XCloseDisplay(m_display); }
+
+		Desktop(const Desktop&)			   = delete;
+		Desktop& operator=(const Desktop&) = delete;
+
+		Window create_window() {
+			const Window window = XCreateSimpleWindow(m_display, m_root, 0, 0, 10, 10, 0, 0, 0);
+			XFlush(m_display);
+			return window;
+		}
+
+		void set_class(const Window window, const char* name) {
+			XClassHint hint {const_cast<char*>(name), const_cast<char*>(name)};
+			XSetClassHint(m_display, window, &hint);
+			XFlush(m_display);
+		}
+
+		void set_pid(const Window window, const long pid) {
+			const auto* data = reinterpret_cast<const unsigned char*>(&pid);
+			XChangeProperty(m_display, window, m_pid_atom, XA_CARDINAL, 32, PropModeReplace, data, 1);
+			XFlush(m_display);
+		}
+
+		void focus(const Window window) {
+			const long	value = static_cast<long>(window);
+			const auto* data  = reinterpret_cast<const unsigned char*>(&value);
+			XChangeProperty(m_display, m_root, m_active_window_atom, XA_WINDOW, 32, PropModeReplace, data, 1);
+			XFlush(m_display);
+		}
+
+		void destroy(const Window window) {
+			XDestroyWindow(m_display, window);
+			XSync(m_display, False);
+		}
+	private:
+		Display* m_display;
+		Window	 m_root;
+		Atom	 m_active_window_atom;
+		Atom	 m_pid_atom;
+	};
+
+	// Dispatches like Hermes' `watch_focus()` task until the watcher reports `expected`, or a second passes.
+	bool settles_on(FocusWatcher& watcher, const bool expected) {
+		const auto deadline = std::chrono::steady_clock::now() + 1s;
+		for (;;) {
+			watcher.dispatch();
+			if (watcher.matches() == expected || std::chrono::steady_clock::now() >= deadline) {
+				return watcher.matches() == expected;
+			}
+			pollfd readable {watcher.fd(), POLLIN, 0};
+			::poll(&readable, 1, 50);
+		}
+	}
+
+	void test_wm_class(const Xvfb& server) {
+		Desktop		 desktop {server.display()};
+		const Window game  = desktop.create_window();
+		const Window xterm = desktop.create_window();
+		desktop.set_class(game, "steam_app_570");
+		desktop.set_class(xterm, "xterm");
+		desktop.focus(game);
+
+		// Focus that was set before the watcher existed is picked up on construction
+		FocusWatcher watcher {parse_rules("steam_app_570"), server.display()};
+		CHECK(watcher.fd() >= 0);
+		CHECK(watcher.matches());
+
+		desktop.focus(xterm);
+		CHECK(settles_on(watcher, false));
+		desktop.focus(game);
+		CHECK(settles_on(watcher, true)); // from the cache
+		desktop.focus(None);
+		CHECK(settles_on(watcher, false));
+	}
+
+	void test_class_set_after_focus(const Xvfb& server) {
+		Desktop		 desktop {server.display()};
+		const Window window = desktop.create_window();
+		FocusWatcher watcher {parse_rules("late_starter"), server.display()};
+
+		desktop.focus(window);
+		CHECK(settles_on(watcher, false));
+
+		// The "no match" remembered for the nameless window must not stick
+		desktop.set_class(window, "late_starter");
+		CHECK(settles_on(watcher, true));
+	}
+
+	void test_executable(const Xvfb& server) {
+		// Longer than the kernel keeps, as for many real programs
+		::prctl(PR_SET_NAME, "hermes-focus-test-process");
+
+		Desktop		 desktop {server.display()};
+		const Window window = desktop.create_window();
+		desktop.set_class(window, "unrelated");
+		FocusWatcher watcher {parse_rules("exe:hermes-focus-test-process"), server.display()};
+
+		desktop.focus(window);
+		CHECK(settles_on(watcher, false));
+		desktop.set_pid(window, ::getpid());
+		CHECK(settles_on(watcher, true));
+	}
+
+	void test_destroyed_window(const Xvfb& server) {
+		Desktop		 desktop {server.display()};
+		const Window game = desktop.create_window();
+		desktop.set_class(game, "steam_app_570");
+		FocusWatcher watcher {parse_rules("steam_app_570"), server.display()};
+
+		desktop.focus(game);
+		CHECK(settles_on(watcher, true));
+
+		// A destroyed window is forgotten, and focusing a window that no longer exists is not an error
+		desktop.destroy(game);
+		desktop.focus(game);
+		CHECK(settles_on(watcher, false));
+
+		const Window other = desktop.create_window();
+		desktop.focus(other);
+		CHECK(settles_on(watcher, false));
+	}
+
+	void test_without_rules(const Xvfb& server) {
+		FocusWatcher watcher {{}, server.display()};
+		CHECK(watcher.fd() < 0);
+		CHECK(!watcher.dispatch());
+		CHECK(!watcher.matches());
+	}
+} // namespace
+
+int main() {
+	const auto server = Xvfb::start();
+	if (!server) {
+		eprintln("Xvfb is not available; skipping");
+		return SKIP;
+	}
+
+	test_wm_class(*server);
+	test_class_set_after_focus(*server);
+	test_executable(*server);
+	test_destroyed_window(*server);
+	test_without_rules(*server);
+	return hermes::test::result();
+}
@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include <string>
+
+#include "media.h"
+#include "test.h"
+
+using namespace std::string_literals;
+using hermes::media::PlaybackMonitor;
+using hermes::test::TempDir;
+
+namespace {
+	// A fake `/proc/asound` with one card that has a playback and a capture device.
+	void add_card(const TempDir& root, const int card) {
+		const auto prefix = std::format("card{}/", card);
+		root.write(prefix + "id", "Fake\n");
+		root.write(prefix + "pcm0p/sub0/status", "closed\n");
+		root.write(prefix + "pcm0p/sub1/status", "closed\n");
+		root.write(prefix + "pcm0c/sub0/status", "closed\n");
+	}
+
+	void test_no_devices() {
+		TempDir			empty;
+		PlaybackMonitor monitor {empty.path()};
+		CHECK(!monitor.has_devices());
+		CHECK(!monitor.is_playing());
+
+		PlaybackMonitor missing {empty.path() / "does-not-exist"};
+		CHECK(!missing.has_devices());
+	}
+
+	void test_playback_state() {
+		TempDir root;
+		add_card(root, 0);
+		PlaybackMonitor monitor {root.path()};
+		CHECK(monitor.has_devices());
+		CHECK(!monitor.is_playing());
+
+		// Capture streams do not count as playback
+		root.write("card0/pcm0c/sub0/status", "state: RUNNING\nowner_pid   : 42\n");
+		CHECK(!monitor.is_playing());
+
+		// The cached descriptors see the new contents without reopening
+		root.write("card0/pcm0p/sub1/status", "state: RUNNING\nowner_pid   : 42\n");
+		CHECK(monitor.is_playing());
+
+		root.write("card0/pcm0p/sub1/status", "state: PAUSED\nowner_pid   : 42\n");
+		CHECK(!monitor.is_playing());
+	}
+
+	void test_hotplug() {
+		TempDir			root;
+		PlaybackMonitor monitor {root.path()};
+		CHECK(!monitor.has_devices());
+
+		add_card(root, 1);
+		root.write("card1/pcm0p/sub0/status", "state: RUNNING\n");
+		const auto added = "add@/devices/pci0000:00/usb1/1-1/sound/card1\0ACTION=add\0DEVPATH=/devices/pci0000:00/"
+						   "usb1/1-1/sound/card1\0SUBSYSTEM=sound\0SEQNUM=4242\0"s;
+		CHECK(hermes::media::is_device_event(added));
+		monitor.rescan();
+		CHECK(monitor.has_devices());
+		CHECK(monitor.is_playing());
+
+		root.remove("card1");
+		const auto removed = "remove@/devices/pci0000:00/usb1/1-1/sound/card1\0ACTION=remove\0SUBSYSTEM=sound\0"s;
+		CHECK(hermes::media::is_device_event(removed));
+		monitor.rescan();
+		CHECK(!monitor.has_devices());
+		CHECK(!monitor.is_playing());
+	}
+
+	// The kernel sends the add event before the card's /proc/asound entries exist
+	void test_late_status_files() {
+		TempDir			root;
+		PlaybackMonitor monitor {root.path()};
+
+		monitor.device_changed();
+		CHECK(!monitor.has_devices());
+
+		add_card(root, 2);
+		root.write("card2/pcm0p/sub0/status", "state: RUNNING\n");
+		CHECK(monitor.is_playing());
+		CHECK(monitor.has_devices());
+	}
+
+	void test_device_event_filter() {
+		using hermes::media::is_device_event;
+		CHECK(!is_device_event("change@/x\0ACTION=change\0SUBSYSTEM=sound\0"s));
+		CHECK(!is_device_event("add@/x\0ACTION=add\0SUBSYSTEM=power_supply\0"s));
+		CHECK(!is_device_event(""));
+	}
+} // namespace
+
+int main() {
+	test_no_devices();
+	test_playback_state();
+	test_hotplug();
+	test_late_status_files();
+	test_device_event_filter();
+	return hermes::test::result();
+}
@@ -0,0 +1,118 @@
+#include "pch.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "notify.h"
+#include "test.h"
+
+using hermes::notify::Notifier;
+using hermes::notify::Urgency;
+using hermes::test::TempDir;
+using namespace std::chrono_literals;
+
+namespace {
+	// A stand-in for `notify-send` that takes `delay` seconds to deliver, like a notification service that is slow to
+	// answer, and logs each delivery's arguments on one line.
+	class FakeNotifySend {
+	public:
+		explicit FakeNotifySend(const std::string_view delay = "0") {
+			m_dir.write(
+				"notify-send",
+				std::format(
+					"#!/bin/sh\nsleep {}\nfor arg in \"$@\"; do printf '%s|' \"$arg\"; done >> '{}'\necho >> '{}'\n",
+					delay,
+					log().string(),
+					log().string()));
+			std::filesystem::permissions(m_dir.path() / "notify-send", std::filesystem::perms::owner_all);
+		}
+
+		[[nodiscard]] std::vector<std::string> command() const { return {(m_dir.path() / "notify-send").string()}; }
+
+		[[nodiscard]] std::vector<std::string> deliveries() const {
+			std::ifstream			 stream {log()};
+			std::vector<std::string> lines;
+			for (std::string line; std::getline(stream, line);) {
+				lines.push_back(line);
+			}
+			return lines;
+		}
+	private:
+		TempDir m_dir;
+
+		[[nodiscard]] std::filesystem::path log() const { return m_dir.path() / "log"; }
+	};
+
+	void test_arguments() {
+		FakeNotifySend fake;
+		{
+			Notifier notifier {fake.command()};
+			notifier.send("Sleep re-enabled", "Running on battery (54%)", Urgency::low);
+		}
+		CHECK(fake.deliveries() == std::vector<std::string> {
+			"--app-name=Hermes|--urgency=low|--|Sleep re-enabled|Running on battery (54%)|"});
+	}
+
+	void test_send_does_not_block() {
+		FakeNotifySend fake {"0.5"};
+		{
+			Notifier   notifier {fake.command()};
+			const auto start = std::chrono::steady_clock::now();
+			notifier.send("first");
+			notifier.send("second");
+			notifier.send("third");
+			CHECK(std::chrono::steady_clock::now() - start < 100ms);
+		}
+		// Destroying the notifier delivers what is still queued
+		CHECK(fake.deliveries().size() == 3);
+	}
+
+	void test_coalescing() {
+		FakeNotifySend fake {"0.2"};
+		{
+			Notifier notifier {fake.command()};
+			for (int i = 0; i < 5; ++i) {
+				notifier.send("Could not open URL", "https://example.com");
+			}
+			notifier.send("Could not open URL", "https://example.org");
+		}
+		CHECK(fake.deliveries().size() == 2);
+	}
+
+	void test_queue_limit() {
+		FakeNotifySend fake {"0.1"};
+		{
+			Notifier notifier {fake.command()};
+			for (std::size_t i = 0; i < 2 * Notifier::MAX_QUEUED; ++i) {
+				notifier.send(std::format("message {}", i));
+			}
+		}
+		// The oldest queued messages are dropped, but the newest always gets through
+		const auto deliveries = fake.deliveries();
+		CHECK(deliveries.size() <= Notifier::MAX_QUEUED + 1);
+		const auto newest = std::format("|message {}|", 2 * Notifier::MAX_QUEUED - 1);
+		CHECK(!deliveries.empty() && deliveries.back().contains(newest));
+	}
+
+	void test_missing_command() {
+		TempDir empty;
+		{
+			// Falls back to logging; neither sending nor shutting down may hang or throw
+			Notifier notifier {{(empty.path() / "notify-send").string()}};
+			notifier.send("first");
+			notifier.send("second");
+		}
+	}
+} // namespace
+
+int main() {
+	test_arguments();
+	test_send_does_not_block();
+	test_coalescing();
+	test_queue_limit();
+	test_missing_command();
+	return hermes::test::result();
+}
@@ -0,0 +1,159 @@
+#include "pch.h"
+
+#include <string>
+
+#include "power.h"
+#include "test.h"
+
+using namespace std::string_literals;
+using hermes::power::PowerMonitor;
+using hermes::test::TempDir;
+
+namespace {
+	// A fake `/sys/class/power_supply` with a plugged-in adapter and a charging battery.
+	void add_laptop(const TempDir& root, const int capacity = 80) {
+		root.write("AC/type", "Mains\n");
+		root.write("AC/online", "1\n");
+		root.write("BAT0/type", "Battery\n");
+		root.write("BAT0/present", "1\n");
+		root.write("BAT0/status", "Charging\n");
+		root.write("BAT0/capacity", std::format("{}\n", capacity));
+	}
+
+	// Builds a uevent as the kernel sends it for the supply called `name`. `properties` holds NUL-terminated
+	// "POWER_SUPPLY_*=value" fields.
+	std::string supply_event(std::string_view action, std::string_view name, const std::string& properties) {
+		const auto devpath = std::format("/devices/LNXSYSTM:00/LNXSYBUS:00/PNP0C0A:00/power_supply/{}", name);
+		return std::format("{}@{}", action, devpath) + '\0' + std::format("ACTION={}", action) + '\0'
+			+ std::format("DEVPATH={}", devpath) + "\0SUBSYSTEM=power_supply\0"s
+			+ std::format("POWER_SUPPLY_NAME={}", name) + '\0' + properties + "SEQNUM=1234\0"s;
+	}
+
+	const auto UNPLUGGED   = "POWER_SUPPLY_TYPE=Mains\0POWER_SUPPLY_ONLINE=0\0"s;
+	const auto PLUGGED_IN  = "POWER_SUPPLY_TYPE=Mains\0POWER_SUPPLY_ONLINE=1\0"s;
+	const auto DISCHARGING = "POWER_SUPPLY_TYPE=Battery\0POWER_SUPPLY_STATUS=Discharging\0"s;
+
+	std::string battery_at(const int capacity, const std::string_view status = "Discharging") {
+		return "POWER_SUPPLY_TYPE=Battery\0"s + std::format("POWER_SUPPLY_STATUS={}", status) + '\0'
+			+ std::format("POWER_SUPPLY_CAPACITY={}", capacity) + '\0';
+	}
+
+	void test_unplug() {
+		TempDir root;
+		add_laptop(root);
+		PowerMonitor monitor {{}, root.path()};
+		CHECK(!monitor.on_battery());
+		CHECK(!monitor.should_pause());
+
+		CHECK(monitor.apply_uevent(supply_event("change", "AC", UNPLUGGED)));
+		CHECK(!monitor.apply_uevent(supply_event("change", "BAT0", DISCHARGING)));
+		CHECK(monitor.on_battery());
+		CHECK(monitor.should_pause());
+
+		CHECK(monitor.apply_uevent(supply_event("change", "AC", PLUGGED_IN)));
+		CHECK(!monitor.should_pause());
+	}
+
+	void test_low_battery_threshold() {
+		TempDir root;
+		add_laptop(root, 50);
+		PowerMonitor monitor {{.pause_on_battery = false}, root.path()};
+
+		monitor.apply_uevent(supply_event("change", "AC", UNPLUGGED));
+		monitor.apply_uevent(supply_event("change", "BAT0", battery_at(50)));
+		CHECK(monitor.on_battery());
+		CHECK(!monitor.should_pause());
+
+		CHECK(monitor.apply_uevent(supply_event("change", "BAT0", battery_at(9))));
+		CHECK(monitor.battery_percent() == 9);
+		CHECK(monitor.should_pause());
+
+		// Back on the adapter and charging: the charge alone does not pause
+		monitor.apply_uevent(supply_event("change", "AC", PLUGGED_IN));
+		CHECK(monitor.apply_uevent(supply_event("change", "BAT0", battery_at(9, "Charging"))));
+		CHECK(!monitor.should_pause());
+
+		// An adapter too weak to keep up: plugged in, yet the battery keeps draining
+		CHECK(monitor.apply_uevent(supply_event("change", "BAT0", battery_at(8))));
+		CHECK(!monitor.on_battery());
+		CHECK(monitor.should_pause());
+	}
+
+	void test_threshold_disabled() {
+		TempDir root;
+		add_laptop(root, 3);
+		root.write("BAT0/status", "Discharging\n");
+		PowerMonitor monitor {{.pause_on_battery = false, .low_battery_percent = -1}, root.path()};
+		CHECK(!monitor.should_pause());
+	}
+
+	void test_device_battery_ignored() {
+		TempDir root;
+		add_laptop(root);
+		PowerMonitor monitor {{}, root.path()};
+
+		// A wireless mouse running flat must not count as the machine's battery
+		const auto mouse = "POWER_SUPPLY_TYPE=Battery\0POWER_SUPPLY_SCOPE=Device\0POWER_SUPPLY_STATUS=Discharging\0"
+						   "POWER_SUPPLY_CAPACITY=2\0"s;
+		CHECK(!monitor.apply_uevent(supply_event("add", "hidpp_battery_0", mouse)));
+		CHECK(monitor.battery_percent() == 80);
+		CHECK(!monitor.should_pause());
+	}
+
+	void test_remove() {
+		TempDir root;
+		add_laptop(root);
+		PowerMonitor monitor {{}, root.path()};
+
+		// Without an adapter the battery's own status decides
+		monitor.apply_uevent(supply_event("change", "BAT0", DISCHARGING));
+		CHECK(!monitor.should_pause());
+		CHECK(monitor.apply_uevent(supply_event("remove", "AC", "")));
+		CHECK(monitor.on_battery());
+		CHECK(monitor.should_pause());
+
+		CHECK(monitor.apply_uevent(supply_event("remove", "BAT0", "")));
+		CHECK(!monitor.on_battery());
+		CHECK(!monitor.should_pause());
+	}
+
+	void test_other_subsystems_ignored() {
+		TempDir root;
+		add_laptop(root);
+		PowerMonitor monitor {{}, root.path()};
+
+		const auto sound = "change@/devices/sound/card0\0ACTION=change\0SUBSYSTEM=sound\0POWER_SUPPLY_NAME=AC\0"
+						   "POWER_SUPPLY_ONLINE=0\0"s;
+		CHECK(!monitor.apply_uevent(sound));
+		CHECK(!monitor.apply_uevent(""));
+		CHECK(!monitor.on_battery());
+	}
+
+	void test_resynchronize() {
+		TempDir root;
+		add_laptop(root);
+		PowerMonitor monitor {{}, root.path()};
+		CHECK(!monitor.resynchronize());
+
+		// Events lost while the socket buffer overflowed
+		root.write("AC/online", "0\n");
+		root.write("BAT0/status", "Discharging\n");
+		CHECK(monitor.resynchronize());
+		CHECK(monitor.should_pause());
+
+		root.remove("BAT0");
+		CHECK(monitor.resynchronize());
+		CHECK(!monitor.on_battery());
+	}
+} // namespace
+
+int main() {
+	test_unplug();
+	test_low_battery_threshold();
+	test_threshold_disabled();
+	test_device_battery_ignored();
+	test_remove();
+	test_other_subsystems_ignored();
+	test_resynchronize();
+	return hermes::test::result();
+}
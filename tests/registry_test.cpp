@@ -0,0 +1,249 @@
+#include "pch.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "registry.h"
+#include "test.h"
+
+using hermes::registry::InhibitRegistry;
+using namespace std::chrono_literals;
+
+namespace {
+	// A registry with a name of its own, unlinked when the test is done.
+	struct ScratchRegistry {
+		std::string		name = std::format("/hermes-test-{}", ::getpid());
+		InhibitRegistry registry {name};
+
+		~ScratchRegistry() { ::shm_unlink(name.c_str()); }
+	};
+
+	// The head of the segment layout, for tests that play a crashed or hostile process: the magic, the live counter,
+	// and the state of the first slot.
+	struct RawHead {
+		std::atomic<std::uint32_t>			  magic;
+		std::atomic<std::int32_t>			  live;
+		std::atomic<std::uint64_t>			  first_slot_state;
+	};
+
+	class RawView {
+	public:
+		explicit RawView(const std::string& name) {
+			const int fd  = ::shm_open(name.c_str(), O_RDWR, 0);
+			void*	  map = ::mmap(nullptr, sizeof(RawHead), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			m_head = static_cast<RawHead*>(map);
+		}
+
+		~RawView() { ::munmap(m_head, sizeof(RawHead)); }
+
+		RawView(const RawView&)			   = delete;
+		RawView& operator=(const RawView&) = delete;
+
+		RawHead* operator->() const noexcept { return m_head; }
+	private:
+		RawHead* m_head;
+	};
+
+	// The state of a slot that `pid` has claimed but not yet published, laid out as the registry does: the phase,
+	// a 16-bit generation, a 22-bit PID and a 24-bit tag of the PID namespace.
+	std::uint64_t claimed_by(const pid_t pid) {
+		struct stat st {};
+		::stat("/proc/self/ns/pid", &st);
+		const std::uint64_t tag = static_cast<std::uint64_t>(st.st_ino) & 0xffffff;
+		return tag << 40 | static_cast<std::uint64_t>(pid) << 18 | 1 << 2 | 1; // generation 1, CLAIMING
+	}
+
+	// Returns the PID of a child that has exited and been waited for.
+	pid_t exited_child() {
+		const pid_t pid = ::fork();
+		if (pid == 0) {
+			::_exit(0);
+		}
+		::waitpid(pid, nullptr, 0);
+		return pid;
+	}
+
+	void test_shared_holds() {
+		ScratchRegistry scratch;
+		auto&			registry = scratch.registry;
+		CHECK(!registry.any_live_holder());
+
+		CHECK(registry.acquire("a"));
+		CHECK(registry.acquire("a"));
+		CHECK(registry.acquire("b"));
+		CHECK(RawView {scratch.name}->live == 2);
+
+		registry.release("a");
+		CHECK(registry.any_live_holder());
+		registry.release("b");
+		registry.release("a");
+		CHECK(!registry.any_live_holder());
+
+		// Our own holds are alive, so reaping leaves them alone
+		CHECK(registry.acquire("c"));
+		CHECK(registry.reap() == 0);
+		CHECK(registry.any_live_holder());
+	}
+
+	void test_expiry() {
+		ScratchRegistry scratch;
+		auto&			registry = scratch.registry;
+		CHECK(registry.acquire("brief", 1s));
+		CHECK(registry.reap() == 0);
+
+		std::this_thread::sleep_for(2100ms);
+		CHECK(registry.reap() == 1);
+		CHECK(!registry.any_live_holder());
+	}
+
+	// A third of the children release their hold, a third exit while holding it (and stay zombies until the end), and
+	// a third hold it until the `release` pipe closes.
+	void test_forked_holders() {
+		constexpr int CHILDREN = 300;
+
+		ScratchRegistry scratch;
+		auto&			registry = scratch.registry;
+
+		// The holding children report on `acquired` once their hold is published, and wait for `release` to close
+		int acquired[2];
+		int release[2];
+		CHECK(::pipe(acquired) == 0);
+		CHECK(::pipe(release) == 0);
+
+		std::vector<pid_t> children;
+		for (int i = 0; i < CHILDREN; ++i) {
+			const pid_t pid = ::fork();
+			if (pid == 0) {
+				// The mapping is shared with the parent, so the child uses it as is rather than opening (and logging)
+				// its own
+				::close(acquired[0]);
+				::close(release[1]);
+				const auto reason = std::format("child {}", i);
+				if (!registry.acquire(reason)) {
+					::_exit(2);
+				}
+				switch (i % 3) {
+				case 0: registry.release(reason); break;
+				case 1: break;
+				case 2: {
+					char byte = 0;
+					if (::write(acquired[1], &byte, 1) != 1) {
+						::_exit(3);
+					}
+					while (::read(release[0], &byte, 1) > 0) {}
+					break;
+				}
+				}
+				::_exit(0);
+			}
+			children.push_back(pid);
+		}
+		::close(acquired[1]);
+		::close(release[0]);
+
+		// Wait for the last third to hold, and for the first two thirds to exit without reaping them
+		char byte;
+		int	 holding = 0;
+		while (holding < CHILDREN / 3 && ::read(acquired[0], &byte, 1) == 1) {
+			++holding;
+		}
+		CHECK(holding == CHILDREN / 3);
+		::close(acquired[0]);
+		for (int i = 0; i < CHILDREN; ++i) {
+			if (i % 3 != 2) {
+				siginfo_t info {};
+				::waitid(P_PID, children[i], &info, WEXITED | WNOWAIT);
+				CHECK(info.si_status == 0);
+			}
+		}
+
+		RawView raw {scratch.name};
+		CHECK(raw->live == 2 * CHILDREN / 3);
+		CHECK(registry.reap() == CHILDREN / 3);
+		CHECK(raw->live == CHILDREN / 3);
+
+		::close(release[1]);
+		for (const pid_t pid : children) {
+			int status = 0;
+			::waitpid(pid, &status, 0);
+		}
+		CHECK(registry.reap() == CHILDREN / 3);
+		CHECK(raw->live == 0);
+		CHECK(!registry.any_live_holder());
+	}
+
+	void test_counter_repair() {
+		ScratchRegistry scratch;
+		auto&			registry = scratch.registry;
+		RawView			raw {scratch.name};
+
+		CHECK(registry.acquire("held"));
+		raw->live = 5;
+		registry.reap();
+		CHECK(raw->live == 5); // a single sighting is not enough
+		registry.reap();
+		CHECK(raw->live == 1);
+
+		raw->live = 0;
+		CHECK(!registry.any_live_holder());
+		registry.reap();
+		registry.reap();
+		CHECK(registry.any_live_holder());
+
+		registry.release("held");
+		CHECK(raw->live == 0);
+	}
+
+	void test_stale_claim() {
+		ScratchRegistry scratch;
+		auto&			registry = scratch.registry;
+		RawView			raw {scratch.name};
+
+		// A process that is still claiming the first slot, however long it takes, keeps it
+		raw->first_slot_state = claimed_by(::getpid());
+
+		std::vector<std::string> reasons;
+		for (std::size_t i = 0; i < InhibitRegistry::CAPACITY; ++i) {
+			reasons.push_back(std::format("hold {}", i));
+		}
+		for (std::size_t i = 0; i + 1 < InhibitRegistry::CAPACITY; ++i) {
+			CHECK(registry.acquire(reasons[i]));
+		}
+		CHECK(!registry.acquire(reasons.back()));
+
+		CHECK(registry.reap() == 0);
+		CHECK(registry.reap() == 0);
+		CHECK(!registry.acquire(reasons.back()));
+
+		// One that died between claiming and publishing does not
+		raw->first_slot_state = claimed_by(exited_child());
+		CHECK(registry.reap() == 1);
+		CHECK(registry.acquire(reasons.back()));
+		CHECK(raw->live == static_cast<std::int32_t>(InhibitRegistry::CAPACITY));
+
+		for (const auto& reason : reasons) {
+			registry.release(reason);
+		}
+		CHECK(!registry.any_live_holder());
+	}
+} // namespace
+
+int main() {
+	test_shared_holds();
+	test_expiry();
+	test_forked_holders();
+	test_counter_repair();
+	test_stale_claim();
+	return hermes::test::result();
+}
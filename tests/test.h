@@ -0,0 +1,66 @@
+#pragma once
+#include <stdlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <source_location>
+#include <string>
+#include <string_view>
+
+#include "error.h"
+
+// Minimal test support: `CHECK()` records failures instead of stopping, and a test's `main()` returns
+// `hermes::test::result()`.
+namespace hermes::test {
+	inline int failures = 0;
+
+	inline bool check(
+		const bool				   condition,
+		const std::string_view	   expression,
+		const std::source_location location = std::source_location::current()) {
+		if (!condition) {
+			eprintln("\033[38;5;1mFAILED\033[m {}:{}: {}", location.file_name(), location.line(), expression);
+			++failures;
+		}
+		return condition;
+	}
+
+	[[nodiscard]] inline int result() {
+		if (failures) {
+			eprintln("{} check(s) failed", failures);
+		}
+		return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	// A scratch directory that is removed with everything in it when the object is destroyed.
+	class TempDir {
+	public:
+		TempDir() {
+			std::string pattern = (std::filesystem::temp_directory_path() / "hermes-test-XXXXXX").string();
+			m_path				= ::mkdtemp(pattern.data());
+		}
+
+		~TempDir() {
+			std::error_code ec;
+			std::filesystem::remove_all(m_path, ec);
+		}
+
+		TempDir(const TempDir&)			   = delete;
+		TempDir& operator=(const TempDir&) = delete;
+
+		[[nodiscard]] const std::filesystem::path& path() const noexcept { return m_path; }
+
+		// Writes `content` to `relative` (creating parent directories), replacing the file's contents in place.
+		void write(const std::filesystem::path& relative, const std::string_view content) const {
+			const auto file = m_path / relative;
+			std::filesystem::create_directories(file.parent_path());
+			std::ofstream {file} << content;
+		}
+
+		void remove(const std::filesystem::path& relative) const { std::filesystem::remove_all(m_path / relative); }
+	private:
+		std::filesystem::path m_path;
+	};
+} // namespace hermes::test
+
+#define CHECK(...) ::hermes::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__)